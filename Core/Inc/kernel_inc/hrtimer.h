@@ -0,0 +1,100 @@
+/*
+ * Created by mikePPeng.
+ * This file declares high resolution timer related APIs.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#ifndef __HRTIMER_H__
+#define __HRTIMER_H__
+
+#include <stdint.h>
+#include "kernel_inc/common.h"
+#include "kernel_inc/os_config.h"
+
+typedef struct hrtimer {
+    void            *timeout_func;   //called in TIM2 interrupt
+    void            *parameter;
+    uint32_t         expire;         //TIM2 count in microsecond to be timeout
+    struct list_head list;           //list of started timers, sorted by @expire
+} hrtimer_t, *p_hrtimer_t;
+
+typedef struct hrtimer_jitter {
+    int32_t  last;    //wake-up jitter of task_sleep_us() in cpu cycle
+    int32_t  min;
+    int32_t  max;
+    uint32_t count;   //number of measured wake-ups
+} hrtimer_jitter_t, *p_hrtimer_jitter_t;
+
+/*
+ * This function is used to initialize TIM2 as a free running microsecond counter, it is called when os starts.
+ * Input:
+ * none
+ * Output:
+ * result: 0 - ok
+ *         1 - fail
+ */
+err_t hrtimer_init(void);
+
+/*
+ * This function is used to get current count of high resolution timer.
+ * Input:
+ * none
+ * Output:
+ * time in microsecond, wraps around every 2^32 microseconds
+ */
+uint32_t hrtimer_now(void);
+
+/*
+ * This function is used to create a high resolution timer.
+ * Input:
+ * timer_handler: handler of timer
+ * timeout_func:  function to call in interrupt when time is up
+ * parameter:     input of timeout function
+ * Output:
+ * none
+ */
+void hrtimer_create(p_hrtimer_t timer_handler,
+                    void (*timeout_func) (void *parameter),
+                    void *parameter);
+
+/*
+ * This function is used to start the given high resolution timer as one shot, a running timer is restarted.
+ * Input:
+ * timer_handler: handler of timer
+ * us:            timeout in microsecond, less than 0x80000000
+ * Output:
+ * none
+ */
+void hrtimer_start(p_hrtimer_t timer_handler,
+                   uint32_t us);
+
+/*
+ * This function is used to stop the given high resolution timer.
+ * Input:
+ * timer_handler: handler of timer
+ * Output:
+ * none
+ */
+void hrtimer_stop(p_hrtimer_t timer_handler);
+
+/*
+ * This function is used to put current task to sleep for given microseconds, it returns at once if scheduler is locked.
+ * Input:
+ * us: time to sleep in microsecond
+ * Output:
+ * none
+ */
+void task_sleep_us(uint32_t us);
+
+/*
+ * This function is used to get wake-up jitter statistic of task_sleep_us().
+ * Input:
+ * jitter: buffer to store the statistic
+ * Output:
+ * none
+ */
+void hrtimer_get_jitter(p_hrtimer_jitter_t jitter);
+
+#endif
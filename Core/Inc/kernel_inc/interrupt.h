@@ -4,12 +4,17 @@
  * Change Logs:
  * Date           Notes
  * Feb 23, 2021   the first version
+ * Oct 18, 2026   mask by BASEPRI instead of PRIMASK
  */
 
 #ifndef __INTERRUPT_H__
 #define __INTERRUPT_H__
 
 #include <stdint.h>
+#include "kernel_inc/os_config.h"
+
+//BASEPRI value of kernel critical section, priority is kept in the high bits
+#define OS_KERNEL_BASEPRI (OS_KERNEL_IRQ_PRIO << (8 - OS_IRQ_PRIO_BITS))
 
 __attribute__((naked)) uint32_t interrupt_disable(void);
 __attribute__((naked)) void interrupt_enable(uint32_t prev_state);
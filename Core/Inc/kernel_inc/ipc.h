@@ -5,6 +5,11 @@
  * Date           Notes
  * Mar 10, 2021   the first version
  * Mar 16, 2021   add message queue
+ * Oct 18, 2026   add interrupt variants
+ * Oct 18, 2026   add message queue over preallocated ring storage
+ * Oct 18, 2026   block sender while static message queue is full
+ * Oct 18, 2026   add zero-copy message queue
+ * Oct 18, 2026   track owner of zero-copy buffer blocks
  */
 
 #ifndef __IPC_H__
@@ -41,9 +46,40 @@ typedef struct msg {
 
 typedef struct msg_queue {
     struct list_head msg_list;
-    struct list_head pend_list;
+    struct list_head pend_list;    //receivers waiting for message
+    struct list_head send_list;    //senders waiting for free slot of static message queue
+
+    //ring storage of static message queue, NULL if messages are allocated from heap
+    uint8_t         *pool;
+    uint32_t         slot_size;   //size header plus item size rounded up to 4 bytes
+    uint32_t         item_size;
+    uint32_t         capacity;
+    uint32_t         head;        //slot of the first message
+    uint32_t         count;
+
+    //buffer blocks of zero-copy message queue, free blocks are linked by their first word
+    uint8_t         *block_state; //one block_state_t per block
+    uint8_t         *block_pool;
+    uint32_t         block_size;
+    uint32_t         block_num;
+    void            *free_block;
+    sem_t            block_sem;   //counts free blocks
 } mq_t, *p_mq_t;
 
+//bytes of storage needed by a static message queue
+#define MSG_QUEUE_POOL_SIZE(item_size, capacity) ((ALIGN((item_size), 4) + sizeof(uint32_t)) * (capacity))
+
+//bytes of storage needed by a zero-copy message queue, a pointer queue, block states and buffer blocks
+#define MSG_QUEUE_ZC_POOL_SIZE(block_size, block_num) \
+    (MSG_QUEUE_POOL_SIZE(sizeof(void *), (block_num)) + ALIGN((block_num), 4) \
+     + ALIGN((block_size), 4) * (block_num))
+
+typedef enum block_state {
+    BLOCK_FREE = 0,    //in free list
+    BLOCK_ALLOCATED,   //owned by the task which allocated or got it
+    BLOCK_POSTED,      //queued, owned by message queue
+} block_state_t;
+
 typedef enum ipc_wait_time {
     WAIT_NONE = 0,
     WAIT_FOREVER = 0xFFFFFFFFU,
@@ -95,6 +131,16 @@ err_t semaphore_take(p_sem_t sem_handler,
  */
 err_t semaphore_release(p_sem_t sem_handler);
 
+/*
+ * This function is used to release the given semaphore in interrupt handler, it never blocks.
+ * Input:
+ * sem_handler: semaphore handler
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ */
+err_t semaphore_release_from_isr(p_sem_t sem_handler);
+
 /*
  * This function is used to create a mutex.
  * Input:
@@ -184,6 +230,17 @@ err_t event_wait(p_event_t     event_handler,
 void event_send(p_event_t event_handler,
                 uint32_t  event);
 
+/*
+ * This function is used to send event in interrupt handler, it never blocks.
+ * Input:
+ * event_handler: event handler
+ * evet:          event to send
+ * Output:
+ * none
+ */
+void event_send_from_isr(p_event_t event_handler,
+                         uint32_t  event);
+
 /*
  * This function is used to create a message queue.
  * Input:
@@ -194,6 +251,96 @@ void event_send(p_event_t event_handler,
  */
 err_t msg_queue_create(p_mq_t msg_handler);
 
+/*
+ * This function is used to create a message queue over the given storage, messages are copied in and out
+ * of a ring buffer, so send and receive never use heap.
+ * Input:
+ * msg_handler: handler of message queue
+ * pool:        storage of MSG_QUEUE_POOL_SIZE(item_size, capacity) bytes, 4 bytes aligned
+ * item_size:   max size of one message, OS_MSG_ITEM_MAX at most
+ * capacity:    max number of messages in queue
+ * Output:
+ * create result: 0 - ok
+ *                1 - fail
+ */
+err_t msg_queue_create_static(p_mq_t msg_handler,
+                              void *pool,
+                              uint32_t item_size,
+                              uint32_t capacity);
+
+/*
+ * This function is used to create a zero-copy message queue over the given storage.
+ * Buffers are allocated from the queue, and only their pointers are passed from sender to receiver.
+ * Input:
+ * msg_handler: handler of message queue
+ * pool:        storage of MSG_QUEUE_ZC_POOL_SIZE(block_size, block_num) bytes, 4 bytes aligned
+ * block_size:  size of one buffer
+ * block_num:   number of buffers
+ * Output:
+ * create result: 0 - ok
+ *                1 - fail
+ */
+err_t msg_queue_create_zc(p_mq_t msg_handler,
+                          void *pool,
+                          uint32_t block_size,
+                          uint32_t block_num);
+
+/*
+ * This function is used to allocate a buffer from zero-copy message queue.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         to store address of allocated buffer
+ * time:        wait time if no buffer is free
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ *              2 - timeout
+ */
+err_t msg_queue_alloc(p_mq_t msg_handler,
+                      void **buf,
+                      uint32_t time);
+
+/*
+ * This function is used to post a filled buffer to zero-copy message queue, it belongs to the receiver then.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         buffer allocated by msg_queue_alloc()
+ * urgent:      urgency of message
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ */
+err_t msg_queue_post(p_mq_t msg_handler,
+                     void *buf,
+                     urgency_t urgent);
+
+/*
+ * This function is used to get a posted buffer from zero-copy message queue, it must be freed after use.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         to store address of received buffer
+ * time:        wait time if message queue is empty
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ *              2 - timeout
+ */
+err_t msg_queue_get(p_mq_t msg_handler,
+                    void **buf,
+                    uint32_t time);
+
+/*
+ * This function is used to give a buffer back to zero-copy message queue.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         buffer allocated by msg_queue_alloc()
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ */
+err_t msg_queue_free(p_mq_t msg_handler,
+                     void *buf);
+
 /*
  * This function is used to send message at the end of message queue.
  * Input:
@@ -201,14 +348,33 @@ err_t msg_queue_create(p_mq_t msg_handler);
  * buf:         address of send message
  * size:        size of send message
  * urgent:      urgency of message
+ * time:        wait time if static message queue is full
  * Output:
  * result:      0 - ok
  *              1 - fail
+ *              2 - timeout
  */
 err_t msg_queue_send(p_mq_t msg_handler,
                      void *buf,
                      uint32_t size,
-                     urgency_t urgent);
+                     urgency_t urgent,
+                     uint32_t time);
+
+/*
+ * This function is used to send message in interrupt handler, it never blocks or allocates memory.
+ * The message is copied to the buffer of the first waiting receiver directly, otherwise it is queued if the
+ * message queue is created by msg_queue_create_static() and not full, or it fails.
+ * Input:
+ * msg_handler: handler of message queue
+ * buf:         address of send message
+ * size:        size of send message
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ */
+err_t msg_queue_send_from_isr(p_mq_t msg_handler,
+                              void *buf,
+                              uint32_t size);
 
 /*
  * This function is used to receive message from message queue.
@@ -4,7 +4,83 @@
  * Change Logs:
  * Date           Notes
  * Mar 2, 2021   the first version
+ * Oct 18, 2026  add priority number of ready bitmap
+ * Oct 18, 2026  add tickless idle switch
+ * Oct 18, 2026  add cpu usage switch
+ * Oct 18, 2026  add stack check switch
+ * Oct 18, 2026  add edf scheduling class
+ * Oct 18, 2026  add execution time budget
+ * Oct 18, 2026  add timer service task
+ * Oct 18, 2026  add high resolution timer
+ * Oct 18, 2026  add kernel interrupt priority ceiling
+ * Oct 18, 2026  add max message size of static message queue
+ * Oct 18, 2026  add switches of sample code which defines interrupt handlers
  */
 
+#ifndef __OS_CONFIG_H__
+#define __OS_CONFIG_H__
 
+//number of task priorities, 0 is the highest, (OS_PRIO_MAX - 1) is reserved for idle task, 256 at most
+#define OS_PRIO_MAX 32
 
+//tickless idle, periodic tick is suppressed while only idle task is ready, 0 - disable, 1 - enable
+#define OS_TICKLESS_IDLE      0
+
+//tickless idle is entered only if the next wake up is at least this many ticks away
+#define OS_TICKLESS_MIN_TICK  2
+
+//per task cpu usage accounting by DWT cycle counter, 0 - disable, 1 - enable
+#define OS_CPU_USAGE          1
+
+//window in tick over which cpu usage is calculated
+#define OS_CPU_USAGE_WINDOW   1000
+
+//paint task stack at creation so that its high water mark can be measured, 0 - disable, 1 - enable
+#define OS_STACK_CHECK        1
+
+//earliest deadline first scheduling class, 0 - disable, 1 - enable
+#define OS_EDF                0
+
+//priority band of edf tasks, ready edf tasks are scheduled by deadline within this priority
+#define OS_EDF_PRIO           8
+
+//max number of edf tasks
+#define OS_EDF_TASK_MAX       16
+
+//per task execution time budget with sporadic server replenishment, 0 - disable, 1 - enable
+#define OS_BUDGET             0
+
+//timer service task, timeout functions run in this task instead of tick interrupt, 0 - disable, 1 - enable
+#define OS_TIMER_TASK         1
+
+//priority and stack size in byte of timer service task
+#define OS_TIMER_TASK_PRIO    1
+#define OS_TIMER_TASK_STACK   0x400
+
+//high resolution timer on 32-bit TIM2 counting in microsecond, 0 - disable, 1 - enable
+#define OS_HRTIMER            0
+
+//nvic preemption priority of TIM2 interrupt, no higher than OS_KERNEL_IRQ_PRIO since it calls kernel APIs
+#define OS_HRTIMER_IRQ_PRIO   5
+
+//number of implemented nvic priority bits
+#define OS_IRQ_PRIO_BITS      4
+
+//highest nvic preemption priority allowed to call kernel APIs, kernel critical sections mask this and lower priorities.
+//interrupts with a smaller priority number are never delayed by kernel, and must not call kernel APIs.
+//every kernel aware interrupt, SysTick included (TICK_INT_PRIORITY), must be configured at or below this priority
+//before any kernel API is used, otherwise it is not masked by critical sections called from main().
+#define OS_KERNEL_IRQ_PRIO    5
+
+//max message size in byte of static message queue. messages are copied in and out of ring storage with
+//interrupt disabled, so this bounds the added interrupt latency, roughly one cpu cycle per byte.
+//larger messages should use message queue on heap or zero-copy message queue.
+#define OS_MSG_ITEM_MAX       64
+
+//sample code below defines strong interrupt handlers, which would override the handlers of application,
+//so it is built only if enabled here, 0 - disable, 1 - enable
+#define OS_SAMPLE_IRQ_LATENCY 0   //TIM6 and TIM7
+#define OS_SAMPLE_RINGBUF     0   //TIM4
+#define OS_SAMPLE_ISR         0   //EXTI0
+
+#endif
@@ -0,0 +1,91 @@
+/*
+ * Created by mikePPeng.
+ * This file declares single producer single consumer ring buffer related APIs.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#ifndef __RINGBUF_H__
+#define __RINGBUF_H__
+
+#include <stdint.h>
+#include "kernel_inc/common.h"
+#include "kernel_inc/ipc.h"
+
+typedef struct ringbuf {
+    uint8_t          *buf;
+    uint32_t          size;        //power of 2
+    volatile uint32_t head;        //free running write index, changed by producer only
+    volatile uint32_t tail;        //free running read index, changed by consumer only
+    uint32_t          threshold;   //consumer is woken up once this many bytes are available, 0 - never
+    volatile uint8_t  waiting;     //consumer is blocked in ringbuf_wait()
+    sem_t             sem;
+} ringbuf_t, *p_ringbuf_t;
+
+/*
+ * This function is used to create a ring buffer over the given storage.
+ * Input:
+ * rb_handler: handler of ring buffer
+ * buf:        storage of ring buffer
+ * size:       size of storage, must be power of 2
+ * threshold:  bytes available to wake up consumer, 0 if consumer never blocks
+ * Output:
+ * create result: 0 - ok
+ *                1 - fail
+ */
+err_t ringbuf_create(p_ringbuf_t rb_handler,
+                     void *buf,
+                     uint32_t size,
+                     uint32_t threshold);
+
+/*
+ * This function is used to write data into ring buffer, it is called by the only producer,
+ * either a task or an interrupt handler wrapped by os_isr_enter() and os_isr_exit().
+ * Input:
+ * rb_handler: handler of ring buffer
+ * data:       data to write
+ * len:        length of data
+ * Output:
+ * number of bytes written, less than @len if ring buffer is full
+ */
+uint32_t ringbuf_put(p_ringbuf_t rb_handler,
+                     const void *data,
+                     uint32_t len);
+
+/*
+ * This function is used to read data from ring buffer, it is called by the only consumer.
+ * Input:
+ * rb_handler: handler of ring buffer
+ * data:       buffer to store read data
+ * len:        size of buffer
+ * Output:
+ * number of bytes read
+ */
+uint32_t ringbuf_get(p_ringbuf_t rb_handler,
+                     void *data,
+                     uint32_t len);
+
+/*
+ * This function is used to get number of bytes available to read.
+ * Input:
+ * rb_handler: handler of ring buffer
+ * Output:
+ * number of bytes in ring buffer
+ */
+uint32_t ringbuf_count(p_ringbuf_t rb_handler);
+
+/*
+ * This function is used to block consumer task until threshold bytes are available.
+ * Input:
+ * rb_handler: handler of ring buffer
+ * time:       time in tick to wait
+ * Output:
+ * result:     0 - ok
+ *             1 - fail
+ *             2 - timeout
+ */
+err_t ringbuf_wait(p_ringbuf_t rb_handler,
+                   uint32_t time);
+
+#endif
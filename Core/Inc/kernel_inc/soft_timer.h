@@ -4,6 +4,10 @@
  * Change Logs:
  * Date           Notes
  * Mar 9, 2021   the first version
+ * Oct 18, 2026  add tickless idle support
+ * Oct 18, 2026  replace delta list with hierarchical timing wheel
+ * Oct 18, 2026  add timer service task
+ * Oct 18, 2026  add timer slack
  */
 
 #ifndef __SOFTWARE_TIMER_H__
@@ -12,10 +16,12 @@
 #include <stdint.h>
 #include <string.h>
 #include "kernel_inc/common.h"
+#include "kernel_inc/os_config.h"
 
 typedef enum software_timer_type {
-    TYPE_ONESHOT = 0,
-    TYPE_REPEAT,
+    TYPE_ONESHOT = 0x00,
+    TYPE_REPEAT = 0x01,
+    TYPE_ISR = 0x02,      //or with other type, timeout function is called in tick interrupt
 } timer_type_t;
 
 typedef struct software_timer {
@@ -23,9 +29,14 @@ typedef struct software_timer {
     void            *timeout_func;
     void            *parameter;
     uint32_t         init_tick;
-    uint32_t         timeout_tick;   //relative tick count calculated using all previous timer list entry
+    uint32_t         slack;          //ticks the timeout may be deferred to fire together with other timers
+    uint32_t         due_tick;       //absolute tick count of timer wheel the timer is due
+    uint32_t         expire_tick;    //absolute tick count of timer wheel to be timeout, within slack after @due_tick
     timer_type_t     type;
+    uint8_t          level;          //wheel level and slot the timer is in
+    uint8_t          slot;
     struct list_head list;
+    struct list_head expired;        //list of expired timers waiting for timer service task
 } soft_timer_t, *p_soft_timer_t;
 
 /*
@@ -35,8 +46,9 @@ typedef struct software_timer {
  * name:          name of timer
  * timeout_func:  function to call when time is up
  * parameter:     input of timeout function
- * init_tick:     timeout of timer in tick
- * type:          type of timer
+ * init_tick:     timeout of timer in tick, less than 0x80000000
+ * slack:         ticks the timeout may be deferred, so that timers close to each other fire in the same tick
+ * type:          type of timer, timeout function is called in timer service task unless TYPE_ISR is set
  * Output:
  * create result: 0 - ok
  *                1 - fail
@@ -46,10 +58,11 @@ err_t soft_timer_create(p_soft_timer_t timer_handler,
                        void (*timeout_func) (void *parameter),
                        void *parameter,
                        uint32_t init_tick,
+                       uint32_t slack,
                        timer_type_t type);
 
 /*
- * This function is used to start the given software timer.
+ * This function is used to start the given software timer, a running timer is restarted.
  * Input:
  * timer_handler: handler of timer
  * Output:
@@ -75,4 +88,35 @@ void soft_timer_stop(p_soft_timer_t timer_handler);
  */
 void soft_timer_check(void);
 
+/*
+ * This function is used to get the ticks until the first timer is timeout.
+ * Input:
+ * none
+ * Output:
+ * ticks to the next timeout, 0xFFFFFFFF if no timer is started
+ */
+uint32_t soft_timer_get_next_timeout(void);
+
+/*
+ * This function is used to advance timer list without checking, used by tickless idle.
+ * No timer is allowed to be timeout during the skipped ticks.
+ * Input:
+ * ticks: tick count to advance
+ * Output:
+ * none
+ */
+void soft_timer_step(uint32_t ticks);
+
+#if OS_TIMER_TASK
+/*
+ * This function is used to create timer service task, it is called when os starts.
+ * Input:
+ * none
+ * Output:
+ * result: 0 - ok
+ *         1 - fail
+ */
+err_t soft_timer_task_create(void);
+#endif
+
 #endif
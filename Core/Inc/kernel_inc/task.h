@@ -6,6 +6,22 @@
  * Feb 23, 2021   the first version
  * Mar  3, 2021   add priority to task
  * Mar 11, 2021   add ipc support to task
+ * Oct 18, 2026   replace priority list with ready bitmap
+ * Oct 18, 2026   add sorted delay list and os tick
+ * Oct 18, 2026   add tickless idle support
+ * Oct 18, 2026   add lazy fpu context switch
+ * Oct 18, 2026   switch context in a single pass without calling c functions
+ * Oct 18, 2026   add cpu usage accounting
+ * Oct 18, 2026   add stack high water mark
+ * Oct 18, 2026   add periodic task delay
+ * Oct 18, 2026   add edf scheduling class
+ * Oct 18, 2026   add execution time budget
+ * Oct 18, 2026   add 64-bit tick and nanosecond time
+ * Oct 18, 2026   ipc timeout by delay list instead of software timer
+ * Oct 18, 2026   add interrupt nesting and deferred reschedule
+ * Oct 18, 2026   add scheduler lock
+ * Oct 18, 2026   add message buffer of blocked sender
+ * Oct 18, 2026   add direct to task notification
  */
 
 #ifndef __TASK_H__
@@ -17,19 +33,69 @@
 #include <string.h>
 #include "kernel_inc/common.h"
 #include "kernel_inc/interrupt.h"
-#include "kernel_inc/soft_timer.h"
+#include "kernel_inc/os_config.h"
 
 #define IDLE_STACK_SIZE 200
 
+//fpu context is switched only if code is compiled with hardware floating point
+#if defined(__VFP_FP__) && !defined(__SOFTFP__)
+#define OS_USE_FPU 1
+#else
+#define OS_USE_FPU 0
+#endif
+
+//pattern painted on unused task stack
+#define STACK_PAINT_PATTERN 0xA5A5A5A5
+
+//initial EXC_RETURN of task, return to thread mode using psp with basic frame
+#define TASK_EXC_RETURN       0xFFFFFFFD
+#define IDLE_PRIO       (OS_PRIO_MAX - 1)
+
+//ready bitmap is organized in groups of 32 priorities, so that highest priority can be found by CLZ
+#define PRIO_GROUP_NUM  ((OS_PRIO_MAX + 31) / 32)
+#define PRIO_BIT(n)     (0x80000000U >> ((n) & 0x1F))
+
 typedef enum task_state {
     TASK_READY,
     TASK_RUNNING,
     TASK_PENDING,
 } task_state;
 
+typedef enum sched_class {
+    SCHED_FIXED = 0,   //scheduled by fixed priority
+    SCHED_EDF,         //scheduled by absolute deadline within OS_EDF_PRIO
+} sched_class_t;
+
+typedef enum budget_policy {
+    BUDGET_SUSPEND = 0,   //task is suspended until its budget is replenished
+    BUDGET_DEMOTE,        //task runs at background priority until its budget is replenished
+} budget_policy_t;
+
+typedef enum notify_action {
+    NOTIFY_SET_BITS = 0,   //notification value is ORed with the given value
+    NOTIFY_INCREMENT,      //notification value is increased by 1, like a counting semaphore
+    NOTIFY_OVERWRITE,      //notification value is replaced by the given value
+} notify_action_t;
+
+typedef enum notify_state {
+    NOTIFY_NONE = 0,       //no notification is pending
+    NOTIFY_WAITING,        //task is blocked in task_notify_wait()
+    NOTIFY_PENDING,        //notification arrived and is not taken yet
+} notify_state_t;
+
+typedef struct period_statistic {
+    uint32_t         release_num;      //jobs released by task_delay_until()
+    uint32_t         overrun_num;      //jobs finished after the next release
+    uint32_t         jitter_last;      //release jitter in nanosecond, tick resolution if OS_CPU_USAGE is disabled
+    uint32_t         jitter_max;
+} period_stat_t;
+
 typedef struct task_control_block {
+    uint32_t        *sp;               //must be the first member, accessed by PendSV_Handler
+#if OS_CPU_USAGE
+    uint32_t         run_cycles;       //must follow @sp, accumulated by PendSV_Handler
+#endif
     char             name[NAME_MAX_LEN];
-    uint32_t        *sp;
     void            *entry;
     void            *parameter;
     task_state       state;
@@ -39,7 +105,24 @@ typedef struct task_control_block {
 
     //used for task delay
     uint32_t         delay_tick;
-    uint32_t         delay_tick_left;
+    uint32_t         wake_tick;        //absolute os tick to wake up
+#if OS_CPU_USAGE
+    uint32_t         wake_cycles;      //cycle count when woken up from delay list
+#endif
+
+    //used for periodic task
+    period_stat_t    period_stat;
+
+#if OS_EDF
+    //used for edf scheduling, deadline is in tick
+    sched_class_t    sched_class;
+    uint32_t         period;
+    uint32_t         rel_deadline;
+    uint32_t         abs_deadline;
+    uint32_t         release_tick;
+    uint32_t         deadline_miss;
+    uint32_t         heap_index;       //index in edf ready heap
+#endif
 
     //used for time slice
     uint32_t         init_tick;
@@ -47,22 +130,51 @@ typedef struct task_control_block {
 
     uint8_t          prio;
 
-    //software timer for ipc
-    soft_timer_t     soft_timer;
+    //result of the last blocking ipc call, ERR_TIMEOUT if it is woken up by timeout
     err_t            error;
 
     uint32_t         event;
     uint32_t         event_flag;
 
-    //list for scheduler
-    struct list_head list;
-} tcb_t, *p_tcb_t;
+    //message buffer registered while waiting on a message queue, set to NULL once the message is handed over
+    void            *msg_buf;
+    uint32_t         msg_size;
+    uint8_t          msg_urgent;   //urgency of message of a blocked sender
 
-typedef struct priority_list {
-    uint8_t          prio;
-    struct list_head task_list_head;   //task list head for each priority
+    //direct to task notification
+    uint32_t         notify_value;
+    uint8_t          notify_state;
+
+#if OS_CPU_USAGE
+    //cycles of last window and cycle count at the start of current window
+    uint32_t         window_cycles;
+    uint32_t         last_run_cycles;
+#endif
+
+    //list for scheduler, task is in ready list of its priority or pending list
     struct list_head list;
-}prio_list_t, *p_prio_list_t;
+
+    //list for delay, sorted by @wake_tick
+    struct list_head delay_list;
+
+#if OS_BUDGET
+    //used for execution time budget, budget is in tick
+    uint32_t         budget;
+    uint32_t         budget_left;
+    uint32_t         budget_period;
+    uint32_t         replenish_tick;
+    uint32_t         budget_exhaust;   //times of budget exhausted
+    budget_policy_t  budget_policy;
+    uint8_t          budget_prio;      //background priority for BUDGET_DEMOTE
+    uint8_t          budget_origin_prio;
+    uint8_t          budget_exhausted;
+    uint8_t          replenish_pending;
+    struct list_head budget_list;      //list for replenishment, sorted by @replenish_tick
+#endif
+
+    //list of all created tasks
+    struct list_head task_list;
+} tcb_t, *p_tcb_t;
 
 /*
  * This function is used to create a task with given task stack.
@@ -117,6 +229,26 @@ err_t task_create(p_tcb_t task_handler,
  */
 void insert_task_to_list(p_tcb_t task_handler);
 
+/*
+ * This function is used to remove the given task from task schedule list.
+ * Input:
+ * task_handler: handler of task
+ * Output:
+ * none
+ */
+void remove_task_from_list(p_tcb_t task_handler);
+
+/*
+ * This function is used to change priority of the given task.
+ * Input:
+ * task_handler: handler of task
+ * prio:         new priority of task
+ * Output:
+ * none
+ */
+void task_change_prio(p_tcb_t task_handler,
+                      uint8_t prio);
+
 /*
  * This function is used to update task state
  * Input:
@@ -136,7 +268,105 @@ void update_task_state(void);
 void task_schedule(void);
 
 /*
- * This function is used to delay a task for given ticks.
+ * This function is used to start timeout of a task blocked on ipc, the task is put into delay list
+ * while it stays in pending list. It must be called with interrupt disabled.
+ * Input:
+ * task_handler: handler of task
+ * tick:         timeout in tick
+ * Output:
+ * none
+ */
+void task_timeout_start(p_tcb_t task_handler,
+                        uint32_t tick);
+
+/*
+ * This function is used to stop timeout of a task blocked on ipc. It must be called with interrupt disabled.
+ * Input:
+ * task_handler: handler of task
+ * Output:
+ * none
+ */
+void task_timeout_stop(p_tcb_t task_handler);
+
+/*
+ * This function is used to mark entry of an interrupt handler which calls kernel APIs.
+ * Reschedule requested inside the handler is deferred until the outermost os_isr_exit().
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void os_isr_enter(void);
+
+/*
+ * This function is used to mark exit of an interrupt handler, PendSV is requested once if any task is woken up.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void os_isr_exit(void);
+
+/*
+ * This function is used to lock scheduler, current task is not switched out until the lock is released.
+ * Interrupts stay enabled, reschedule requested meanwhile is deferred to the last task_sched_unlock().
+ * It can be nested, and task must not block while holding it, blocking APIs return fail or return at once then.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void task_sched_lock(void);
+
+/*
+ * This function is used to unlock scheduler, deferred reschedule is done when lock count returns to 0.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void task_sched_unlock(void);
+
+/*
+ * This function is used to check whether scheduler is locked, blocking APIs fail if it is.
+ * Input:
+ * none
+ * Output:
+ * 1 if scheduler is locked, otherwise 0
+ */
+uint8_t task_sched_locked(void);
+
+/*
+ * This function is used to notify the given task, it never blocks and can be called in interrupt handler.
+ * Input:
+ * task_handler: handler of task to notify
+ * value:        value used by @action
+ * action:       how notification value is updated
+ * Output:
+ * result:       0 - ok
+ *               1 - fail
+ */
+err_t task_notify(p_tcb_t task_handler,
+                  uint32_t value,
+                  notify_action_t action);
+
+/*
+ * This function is used to wait notification of current task.
+ * Input:
+ * clear_on_exit: bits of notification value cleared after it is read, 0xFFFFFFFF to reset it
+ * value:         to store notification value before clearing, can be NULL
+ * time:          time in tick to wait
+ * Output:
+ * result:        0 - ok
+ *                1 - fail, scheduler is locked
+ *                2 - timeout
+ */
+err_t task_notify_wait(uint32_t clear_on_exit,
+                       uint32_t *value,
+                       uint32_t time);
+
+/*
+ * This function is used to delay a task for given ticks, it returns at once if scheduler is locked.
  * Input:
  * tick: tick count to delay
  * Output:
@@ -144,6 +374,124 @@ void task_schedule(void);
  */
 void task_delay(uint32_t tick);
 
+/*
+ * This function is used to delay a task until an absolute tick, for drift-free periodic task.
+ * It returns at once if scheduler is locked.
+ * If the next release has already passed, the task is not delayed and an overrun is counted.
+ * Input:
+ * last_wake: tick of last release, initialized by os_tick_get() and updated on each call
+ * period:    period in tick
+ * Output:
+ * none
+ */
+void task_delay_until(uint32_t *last_wake,
+                      uint32_t period);
+
+#if OS_EDF
+/*
+ * This function is used to move the given task into edf scheduling class.
+ * Its first job is released now, with an absolute deadline of now + @deadline.
+ * Input:
+ * task_handler: task control block of task
+ * period:       period of task in tick
+ * deadline:     relative deadline of each job in tick
+ * Output:
+ * result:       0 - ok
+ *               1 - fail
+ */
+err_t task_set_edf(p_tcb_t task_handler,
+                   uint32_t period,
+                   uint32_t deadline);
+
+/*
+ * This function is used to finish current job of an edf task and wait for release of the next job.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void task_wait_next_period(void);
+#endif
+
+#if OS_BUDGET
+/*
+ * This function is used to set execution time budget of the given task.
+ * Budget is consumed by running ticks of the task, and is replenished @period ticks after
+ * the task starts consuming it. When it is exhausted, the task is suspended or demoted.
+ * Input:
+ * task_handler: task control block of task
+ * budget:       budget in tick
+ * period:       replenishment period in tick
+ * policy:       action when budget is exhausted
+ * prio:         background priority for BUDGET_DEMOTE
+ * Output:
+ * result:       0 - ok
+ *               1 - fail
+ */
+err_t task_set_budget(p_tcb_t task_handler,
+                      uint32_t budget,
+                      uint32_t period,
+                      budget_policy_t policy,
+                      uint8_t prio);
+#endif
+
+/*
+ * This function is used to get current os tick count.
+ * Input:
+ * none
+ * Output:
+ * ticks elapsed since os is started
+ */
+uint32_t os_tick_get(void);
+
+/*
+ * This function is used to get current os tick count in 64 bits, which never wraps around in practice.
+ * Input:
+ * none
+ * Output:
+ * ticks elapsed since SysTick is started
+ */
+uint64_t os_tick_get64(void);
+
+/*
+ * This function is used to get monotonic time in nanosecond, interpolated within current tick by SysTick counter.
+ * While tickless idle suppresses the tick, it is only accurate to the tick. It returns 0 before os starts.
+ * Input:
+ * none
+ * Output:
+ * nanoseconds elapsed since SysTick is started
+ */
+uint64_t os_time_ns(void);
+
+/*
+ * This function is used to advance os tick count without processing, used by tickless idle.
+ * No task is allowed to expire during the skipped ticks.
+ * Input:
+ * ticks: tick count to advance
+ * Output:
+ * none
+ */
+void os_tick_step(uint32_t ticks);
+
+/*
+ * This function is used to get the ticks until the first delayed task wakes up.
+ * Input:
+ * none
+ * Output:
+ * ticks to the next wake up, 0xFFFFFFFF if no task is delayed
+ */
+uint32_t task_get_next_wake(void);
+
+/*
+ * This function is used to check whether idle task is the only ready task.
+ * Input:
+ * none
+ * Output:
+ * 1 - only idle task is ready
+ * 0 - other task is ready
+ */
+uint8_t task_is_idle_only(void);
+
 /*
  * This function is used to show task info.
  * Input:
@@ -171,4 +519,53 @@ void os_start_schedule(void);
  */
 p_tcb_t task_get_self(void);
 
+#if OS_STACK_CHECK
+/*
+ * This function is used to get the minimum free stack of the given task since it is created.
+ * Input:
+ * task_handler: task control block of task
+ * Output:
+ * free stack in byte which has never been used
+ */
+uint32_t task_get_stack_free(p_tcb_t task_handler);
+
+/*
+ * This function is used to show used and allocated stack of all tasks.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void show_stack_usage(void);
+#endif
+
+#if OS_CPU_USAGE
+/*
+ * This function is used to get cpu usage of the given task over the last window.
+ * Input:
+ * task_handler: task control block of task
+ * Output:
+ * cpu usage in permille
+ */
+uint32_t task_get_cpu_usage(p_tcb_t task_handler);
+
+/*
+ * This function is used to get total cpu load over the last window, time spent in idle task is excluded.
+ * Input:
+ * none
+ * Output:
+ * cpu load in permille
+ */
+uint32_t os_get_cpu_load(void);
+
+/*
+ * This function is used to show cpu usage of all tasks.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void show_cpu_usage(void);
+#endif
+
 #endif
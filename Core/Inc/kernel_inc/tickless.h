@@ -0,0 +1,44 @@
+/*
+ * Created by mikePPeng.
+ * This file declares tickless idle related APIs.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ * Oct 18, 2026   take SysTick counts of one tick from scheduler
+ */
+
+#ifndef __TICKLESS_H__
+#define __TICKLESS_H__
+
+#include <stdint.h>
+#include "kernel_inc/os_config.h"
+
+/*
+ * This function is used to initialize tickless idle, it must be called after SysTick is configured.
+ * Input:
+ * tick_cycles: SysTick counts of one tick
+ * Output:
+ * none
+ */
+void tickless_init(uint32_t tick_cycles);
+
+/*
+ * This function is used to put cpu into sleep until next task or timer wakes up.
+ * It is called by idle task only.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void tickless_idle(void);
+
+/*
+ * This function is used to get the number of wake-ups from idle sleep.
+ * Input:
+ * none
+ * Output:
+ * wake-up count since os is started
+ */
+uint32_t tickless_get_wakeups(void);
+
+#endif
@@ -4,15 +4,15 @@
  * Change Logs:
  * Date           Notes
  * Mar 17, 2021   the first version
+ * Oct 18, 2026   protect heap by scheduler lock instead of mutex
  */
 
 #include <stdarg.h>
 #include "kernel_inc/common.h"
-#include "kernel_inc/ipc.h"
+#include "kernel_inc/task.h"
 
 uint32_t heap_start;
 uint32_t heap_end;
-mutex_t heap_mutex;
 
 /*
  * This function is used to initialize heap memory.
@@ -50,11 +50,6 @@ err_t heap_init(void)
     mem->next = heap_end - SIZEOF_MEM;
     mem->prev = 0;
 
-    if (mutex_create(&heap_mutex) != ERR_OK) {
-        printf("heap mutex create fail!\r\n");
-        return ERR_FAIL;
-    }
-
     return ERR_OK;
 }
 
@@ -70,18 +65,21 @@ void *os_malloc(uint32_t in_size)
     p_mem_t mem = (p_mem_t)heap_start;
     uint32_t size = ALIGN(in_size, 4);
 
-    mutex_take(&heap_mutex, WAIT_FOREVER);
+    //heap is only used by tasks, so scheduler lock is enough and interrupts are kept enabled
+    task_sched_lock();
 
     while (mem != NULL && (mem->used || mem->size < size)) {
         mem = (p_mem_t)(mem->next);
     }
 
     if (mem == NULL) {
+        task_sched_unlock();
         printf("Not enough heap memory left to malloc %lu bytes.\r\n", size);
         return NULL;
     } else {
         //check magic
         if (mem->magic != MAGIC) {
+            task_sched_unlock();
             printf("memory is corrupted during malloc!\r\n");
             return NULL;
         }
@@ -107,7 +105,7 @@ void *os_malloc(uint32_t in_size)
         }
     }
 
-    mutex_release(&heap_mutex);
+    task_sched_unlock();
 
     return (void *)((uint32_t)mem + SIZEOF_MEM);
 }
@@ -126,11 +124,12 @@ void os_free(void *addr)
         return;
     }
 
-    mutex_take(&heap_mutex, WAIT_FOREVER);
+    task_sched_lock();
 
     p_mem_t mem = (p_mem_t)((uint32_t)addr - SIZEOF_MEM);
 
     if (mem->magic != MAGIC) {
+        task_sched_unlock();
         printf("memory is corrupted during free!\r\n");
         return;
     }
@@ -156,7 +155,7 @@ void os_free(void *addr)
         cur_next->prev = (uint32_t)mem;
     }
 
-    mutex_release(&heap_mutex);
+    task_sched_unlock();
 
     return;
 }
@@ -0,0 +1,280 @@
+/*
+ * Created by mikePPeng.
+ * This file implements high resolution timer on 32-bit TIM2, which counts in microsecond.
+ * Started timers are kept in a list sorted by expire count, compare register 1 is always set to the first one.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/hrtimer.h"
+#include "kernel_inc/task.h"
+
+#if OS_HRTIMER
+
+#define HRTIMER_CLOCK 1000000U   //counting frequency of TIM2 in Hz
+
+static TIM_HandleTypeDef g_hrtimer_handle;
+list_head_init(g_hrtimer_list_head);
+static hrtimer_jitter_t g_hrtimer_jitter = {0, 0x7FFFFFFF, (int32_t)0x80000000, 0};
+
+/*
+ * This function is used to set compare register to the first timer, must be called with interrupt disabled.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+static void hrtimer_program(void)
+{
+    if (list_empty(&g_hrtimer_list_head)) {
+        __HAL_TIM_DISABLE_IT(&g_hrtimer_handle, TIM_IT_CC1);
+        return;
+    }
+
+    p_hrtimer_t timer = list_entry(g_hrtimer_list_head.next, typeof(hrtimer_t), list);
+    __HAL_TIM_SET_COMPARE(&g_hrtimer_handle, TIM_CHANNEL_1, timer->expire);
+    __HAL_TIM_ENABLE_IT(&g_hrtimer_handle, TIM_IT_CC1);
+
+    //compare match is missed if counter has passed the deadline already, trigger it by software
+    if ((int32_t)(timer->expire - __HAL_TIM_GET_COUNTER(&g_hrtimer_handle)) <= 0) {
+        g_hrtimer_handle.Instance->EGR = TIM_EGR_CC1G;
+    }
+}
+
+/*
+ * This function is used to initialize TIM2 as a free running microsecond counter, it is called when os starts.
+ * Input:
+ * none
+ * Output:
+ * result: 0 - ok
+ *         1 - fail
+ */
+err_t hrtimer_init(void)
+{
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    //timer clock is twice of PCLK1 if APB1 is divided
+    uint32_t clock = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        clock *= 2;
+    }
+
+    g_hrtimer_handle.Instance = TIM2;
+    g_hrtimer_handle.Init.Prescaler = clock / HRTIMER_CLOCK - 1;
+    g_hrtimer_handle.Init.CounterMode = TIM_COUNTERMODE_UP;
+    g_hrtimer_handle.Init.Period = 0xFFFFFFFF;
+    g_hrtimer_handle.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    g_hrtimer_handle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&g_hrtimer_handle) != HAL_OK) {
+        return ERR_FAIL;
+    }
+
+    //channel 1 is left in frozen output compare mode, only its compare flag is used
+    __HAL_TIM_CLEAR_IT(&g_hrtimer_handle, TIM_IT_CC1);
+    HAL_NVIC_SetPriority(TIM2_IRQn, OS_HRTIMER_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(TIM2_IRQn);
+
+    //DWT cycle counter is used to measure wake-up jitter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    if (HAL_TIM_Base_Start(&g_hrtimer_handle) != HAL_OK) {
+        return ERR_FAIL;
+    }
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to get current count of high resolution timer.
+ * Input:
+ * none
+ * Output:
+ * time in microsecond, wraps around every 2^32 microseconds
+ */
+uint32_t hrtimer_now(void)
+{
+    return __HAL_TIM_GET_COUNTER(&g_hrtimer_handle);
+}
+
+/*
+ * This function is used to create a high resolution timer.
+ * Input:
+ * timer_handler: handler of timer
+ * timeout_func:  function to call in interrupt when time is up
+ * parameter:     input of timeout function
+ * Output:
+ * none
+ */
+void hrtimer_create(p_hrtimer_t timer_handler,
+                    void (*timeout_func) (void *parameter),
+                    void *parameter)
+{
+    timer_handler->timeout_func = (void *)timeout_func;
+    timer_handler->parameter = parameter;
+    timer_handler->expire = 0;
+    timer_handler->list.next = NULL;
+}
+
+/*
+ * This function is used to start the given high resolution timer as one shot, a running timer is restarted.
+ * Input:
+ * timer_handler: handler of timer
+ * us:            timeout in microsecond, less than 0x80000000
+ * Output:
+ * none
+ */
+void hrtimer_start(p_hrtimer_t timer_handler,
+                   uint32_t us)
+{
+    uint32_t level = interrupt_disable();
+    if (timer_handler->list.next != NULL) {
+        list_del(&timer_handler->list);
+    }
+
+    timer_handler->expire = hrtimer_now() + us;
+
+    //insert before the first timer which expires later
+    p_hrtimer_t itr = NULL;
+    list_for_each_entry(itr, &g_hrtimer_list_head, list) {
+        if ((int32_t)(itr->expire - timer_handler->expire) > 0) {
+            break;
+        }
+    }
+    list_add_before(&timer_handler->list, &itr->list);
+
+    if (g_hrtimer_list_head.next == &timer_handler->list) {
+        //new first timer
+        hrtimer_program();
+    }
+    interrupt_enable(level);
+}
+
+/*
+ * This function is used to stop the given high resolution timer.
+ * Input:
+ * timer_handler: handler of timer
+ * Output:
+ * none
+ */
+void hrtimer_stop(p_hrtimer_t timer_handler)
+{
+    uint32_t level = interrupt_disable();
+    if (timer_handler->list.next != NULL) {
+        uint8_t first = (g_hrtimer_list_head.next == &timer_handler->list);
+        list_del(&timer_handler->list);
+        if (first) {
+            hrtimer_program();
+        }
+    }
+    interrupt_enable(level);
+}
+
+/*
+ * This function is the timeout function of task_sleep_us(), it makes the sleeping task ready.
+ * Input:
+ * parameter: handler of sleeping task
+ * Output:
+ * none
+ */
+static void hrtimer_wake_task(void *parameter)
+{
+    p_tcb_t task = (p_tcb_t)parameter;
+    task->state = TASK_READY;
+    insert_task_to_list(task);
+    task_schedule();
+}
+
+/*
+ * This function is used to put current task to sleep for given microseconds, it returns at once if scheduler is locked.
+ * Input:
+ * us: time to sleep in microsecond
+ * Output:
+ * none
+ */
+void task_sleep_us(uint32_t us)
+{
+    hrtimer_t timer;
+    p_tcb_t self = task_get_self();
+
+    //task must not block while holding scheduler lock
+    if (task_sched_locked()) {
+        return;
+    }
+
+    hrtimer_create(&timer, hrtimer_wake_task, self);
+
+    uint32_t level = interrupt_disable();
+    uint32_t target = DWT->CYCCNT + us * (SystemCoreClock / HRTIMER_CLOCK);
+    self->state = TASK_PENDING;
+    remove_task_from_list(self);
+    hrtimer_start(&timer, us);
+    interrupt_enable(level);
+
+    task_schedule();
+
+    //task runs again, measure how late it is
+    int32_t jitter = (int32_t)(DWT->CYCCNT - target);
+    level = interrupt_disable();
+    g_hrtimer_jitter.last = jitter;
+    if (jitter < g_hrtimer_jitter.min) {
+        g_hrtimer_jitter.min = jitter;
+    }
+    if (jitter > g_hrtimer_jitter.max) {
+        g_hrtimer_jitter.max = jitter;
+    }
+    g_hrtimer_jitter.count++;
+    interrupt_enable(level);
+}
+
+/*
+ * This function is used to get wake-up jitter statistic of task_sleep_us().
+ * Input:
+ * jitter: buffer to store the statistic
+ * Output:
+ * none
+ */
+void hrtimer_get_jitter(p_hrtimer_jitter_t jitter)
+{
+    uint32_t level = interrupt_disable();
+    *jitter = g_hrtimer_jitter;
+    interrupt_enable(level);
+}
+
+/*
+ * This function is used to handle TIM2 interrupt, timeout functions of all expired timers are called.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void TIM2_IRQHandler(void)
+{
+    //tasks woken up by expired timers are scheduled once at os_isr_exit()
+    os_isr_enter();
+
+    __HAL_TIM_CLEAR_IT(&g_hrtimer_handle, TIM_IT_CC1);
+
+    uint32_t level = interrupt_disable();
+    while (!list_empty(&g_hrtimer_list_head)) {
+        p_hrtimer_t timer = list_entry(g_hrtimer_list_head.next, typeof(hrtimer_t), list);
+        if ((int32_t)(timer->expire - hrtimer_now()) > 0) {
+            break;
+        }
+
+        list_del(&timer->list);
+
+        //time is up
+        interrupt_enable(level);
+        ((void (*) (void *))timer->timeout_func)(timer->parameter);
+        level = interrupt_disable();
+    }
+    hrtimer_program();
+    interrupt_enable(level);
+
+    os_isr_exit();
+}
+
+#endif
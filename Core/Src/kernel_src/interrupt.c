@@ -4,19 +4,29 @@
  * Change Logs:
  * Date           Notes
  * Feb 23, 2021   the first version
+ * Oct 18, 2026   mask by BASEPRI instead of PRIMASK
  */
 
 #include "kernel_inc/interrupt.h"
 
+#define STR(x)  #x
+#define XSTR(x) STR(x)
+
+/*
+ * Only interrupts at or below OS_KERNEL_IRQ_PRIO are masked, higher ones keep running during kernel critical sections.
+ */
 __attribute__((naked)) uint32_t interrupt_disable(void)
 {
-    __asm volatile("MRS R0, PRIMASK");
-    __asm volatile("CPSID I");
+    __asm volatile("MRS R0, BASEPRI");
+    __asm volatile("MOV R1, #" XSTR(OS_KERNEL_BASEPRI));
+    __asm volatile("MSR BASEPRI, R1");
+    __asm volatile("DSB");
+    __asm volatile("ISB");
     __asm volatile("BX LR");
 }
 
 __attribute__((naked)) void interrupt_enable(uint32_t prev_state)
 {
-    __asm volatile("MSR PRIMASK, R0");
+    __asm volatile("MSR BASEPRI, R0");
     __asm volatile("BX LR");
 }
@@ -5,6 +5,12 @@
  * Date           Notes
  * Mar 10, 2021   the first version
  * Mar 16, 2021   add message queue
+ * Oct 18, 2026   ipc timeout by delay list instead of software timer
+ * Oct 18, 2026   add interrupt variants, hand message to waiting receiver directly
+ * Oct 18, 2026   add message queue over preallocated ring storage
+ * Oct 18, 2026   block sender while static message queue is full
+ * Oct 18, 2026   add zero-copy message queue
+ * Oct 18, 2026   track owner of zero-copy buffer blocks
  */
 
 #include "kernel_inc/ipc.h"
@@ -14,14 +20,24 @@
  * Input:
  * sem_handler:  handler of semaphore
  * task_handler: handler of task
+ * time:         time in tick to wait
  * Output:
  * none
  */
 void pend_list_add(struct list_head *head,
-                   p_tcb_t task_handler)
+                   p_tcb_t task_handler,
+                   uint32_t time)
 {
+    uint32_t level = interrupt_disable();
+
+    //the task also waits in delay list if it has a timeout
+    task_handler->error = ERR_OK;
+    if (time != WAIT_FOREVER) {
+        task_timeout_start(task_handler, time);
+    }
+
     //first remove entry from schedule list
-    list_del(&task_handler->list);
+    remove_task_from_list(task_handler);
     task_handler->state = TASK_PENDING;
 
     //then add entry to pending list
@@ -48,16 +64,23 @@ void pend_list_add(struct list_head *head,
             }
         }
     }
+
+    interrupt_enable(level);
 }
 
 void pend_list_del(p_tcb_t task_handler)
 {
-    //first remove entry from pending list
+    uint32_t level = interrupt_disable();
+
+    //first remove entry from pending list and delay list
     list_del(&task_handler->list);
+    task_timeout_stop(task_handler);
 
     //then add entry to scheduler list
     task_handler->state = TASK_READY;
     insert_task_to_list(task_handler);
+
+    interrupt_enable(level);
 }
 
 /*
@@ -85,17 +108,6 @@ err_t semaphore_create(p_sem_t sem_handler,
     return ERR_OK;
 }
 
-void ipc_timer(void *parameter)
-{
-    //time is up, schedule current task anyway
-    p_tcb_t cur_task = (p_tcb_t)parameter;
-    cur_task->error = ERR_TIMEOUT;
-    pend_list_del(cur_task);
-
-    //do schedule
-    task_schedule();
-}
-
 /*
  * This function is used to take the given semaphore.
  * Input:
@@ -113,29 +125,27 @@ err_t semaphore_take(p_sem_t sem_handler,
         return ERR_FAIL;
     }
 
+    //check and pend in one critical section, so that a release from interrupt is not lost in between
+    uint32_t level = interrupt_disable();
     if (sem_handler->value > 0) {
-        uint32_t level = interrupt_disable();
         sem_handler->value--;
         interrupt_enable(level);
     } else {
         if (time == WAIT_NONE) {   //no wait time, return
+            interrupt_enable(level);
             return ERR_TIMEOUT;
         }
 
-        p_tcb_t cur_task = task_get_self();
-        pend_list_add(&sem_handler->pend_list, cur_task);
-        cur_task->soft_timer.timeout_func = NULL;
-
-        if (time != WAIT_FOREVER) {
-            soft_timer_create(&cur_task->soft_timer,
-                              cur_task->name,
-                              ipc_timer,
-                              cur_task,
-                              time,
-                              TYPE_ONESHOT);
-            soft_timer_start(&cur_task->soft_timer);
+        //task must not block while holding scheduler lock
+        if (task_sched_locked()) {
+            interrupt_enable(level);
+            return ERR_FAIL;
         }
 
+        p_tcb_t cur_task = task_get_self();
+        pend_list_add(&sem_handler->pend_list, cur_task, time);
+        interrupt_enable(level);
+
         //do schedule
         task_schedule();
 
@@ -158,28 +168,41 @@ err_t semaphore_release(p_sem_t sem_handler)
         return ERR_FAIL;
     }
 
+    uint8_t wake = 0;
+
+    //waiter is picked and removed in one critical section, the same one cannot be taken by interrupt
+    uint32_t level = interrupt_disable();
     if (!list_empty(&sem_handler->pend_list)) {
         //the first entry of pending list
         p_tcb_t pend_task = list_entry(sem_handler->pend_list.next, typeof(tcb_t), list);
-
-        //stop software timer
-        if (pend_task->soft_timer.timeout_func != NULL) {
-            soft_timer_stop(&pend_task->soft_timer);
-            pend_task->error = ERR_OK;
-        }
-
         pend_list_del(pend_task);
+        wake = 1;
+    } else {
+        sem_handler->value++;
+    }
+    interrupt_enable(level);
 
+    if (wake) {
         //do schedule
         task_schedule();
-    } else {
-        uint32_t level = interrupt_disable();
-        sem_handler->value++;
-        interrupt_enable(level);
     }
     return ERR_OK;
 }
 
+/*
+ * This function is used to release the given semaphore in interrupt handler, it never blocks.
+ * Input:
+ * sem_handler: semaphore handler
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ */
+err_t semaphore_release_from_isr(p_sem_t sem_handler)
+{
+    //semaphore_release() never blocks, and its reschedule is deferred to os_isr_exit() in interrupt handler
+    return semaphore_release(sem_handler);
+}
+
 /*
  * This function is used to create a mutex.
  * Input:
@@ -225,42 +248,36 @@ err_t mutex_take(p_mutex_t mutex_handler,
 
     p_tcb_t cur_task = task_get_self();
 
+    uint32_t level = interrupt_disable();
     if (mutex_handler->sem.value == 1) {   //mutex is available
-        uint32_t level = interrupt_disable();
         mutex_handler->sem.value--;
         mutex_handler->owner = cur_task;
         mutex_handler->origin_prio = cur_task->prio;
         mutex_handler->recursive_time++;
-        interrupt_enable(level);
     } else {   //mutex is not available
         if (cur_task == mutex_handler->owner) {   //recursive
             mutex_handler->recursive_time++;
         } else {   //other tasks
             if (time == WAIT_NONE) {   //no wait time, return error
+                interrupt_enable(level);
                 return ERR_TIMEOUT;
             }
 
+            //task must not block while holding scheduler lock
+            if (task_sched_locked()) {
+                interrupt_enable(level);
+                return ERR_FAIL;
+            }
+
             //add to pending list
-            pend_list_add(&mutex_handler->sem.pend_list, cur_task);
-            cur_task->soft_timer.timeout_func = NULL;
+            pend_list_add(&mutex_handler->sem.pend_list, cur_task, time);
 
             //prevent priority reverse
             p_tcb_t first_entry = list_entry(mutex_handler->sem.pend_list.next, typeof(tcb_t), list);
             if (mutex_handler->owner->prio > first_entry->prio) {
-                list_del(&mutex_handler->owner->list);
-                mutex_handler->owner->prio = first_entry->prio;
-                insert_task_to_list(mutex_handler->owner);
-            }
-
-            if (time != WAIT_FOREVER) {
-                soft_timer_create(&cur_task->soft_timer,
-                                  cur_task->name,
-                                  ipc_timer,
-                                  cur_task,
-                                  time,
-                                  TYPE_ONESHOT);
-                soft_timer_start(&cur_task->soft_timer);
+                task_change_prio(mutex_handler->owner, first_entry->prio);
             }
+            interrupt_enable(level);
 
             //do schedule
             task_schedule();
@@ -268,6 +285,7 @@ err_t mutex_take(p_mutex_t mutex_handler,
             return cur_task->error;
         }
     }
+    interrupt_enable(level);
     return ERR_OK;
 }
 
@@ -298,19 +316,11 @@ err_t mutex_release(p_mutex_t mutex_handler)
         if (!list_empty(&mutex_handler->sem.pend_list)) {   //pend list is not empty
             p_tcb_t pend_task = list_entry(mutex_handler->sem.pend_list.next, typeof(tcb_t), list);
 
-            //stop software timer
-            if (pend_task->soft_timer.timeout_func != NULL) {
-                soft_timer_stop(&pend_task->soft_timer);
-                pend_task->error = ERR_OK;
-            }
-
             pend_list_del(pend_task);
 
             //reset previous owner priority to original
             if (mutex_handler->owner->prio != mutex_handler->origin_prio) {
-                list_del(&mutex_handler->owner->list);
-                mutex_handler->owner->prio = mutex_handler->origin_prio;
-                insert_task_to_list(mutex_handler->owner);
+                task_change_prio(mutex_handler->owner, mutex_handler->origin_prio);
             }
 
             //change owner of mutex
@@ -401,74 +411,49 @@ err_t event_wait(p_event_t     event_handler,
                  event_flag_t  flag,
                  uint32_t      time)
 {
-    uint32_t ret = ERR_FAIL;
     if (event_handler == NULL) {
-        return ret;
+        return ERR_FAIL;
     }
 
     p_tcb_t cur_task = task_get_self();
+    err_t ret = ERR_OK;
+
+    //check and pend in one critical section, so that an event sent from interrupt is not lost in between
+    uint32_t level = interrupt_disable();
     cur_task->event_flag = flag;
 
+    uint8_t match;
     if (flag & EVENT_FLAG_AND) {
-        if ((cur_task->event & event_handler->bit_table) != cur_task->event) {
-            //no wait time, return timeout
-            if (time == WAIT_NONE) {
-                return ERR_TIMEOUT;
-            }
-
-            //add current task to pending list
-            pend_list_add(&event_handler->pend_list, cur_task);
-            cur_task->soft_timer.timeout_func = NULL;
-
-            //add software timer
-            if (time != WAIT_FOREVER) {
-                soft_timer_create(&cur_task->soft_timer,
-                                  cur_task->name,
-                                  ipc_timer,
-                                  cur_task,
-                                  time,
-                                  TYPE_ONESHOT);
-                soft_timer_start(&cur_task->soft_timer);
-            }
-
-            //do schedule
-            task_schedule();
+        match = ((cur_task->event & event_handler->bit_table) == cur_task->event);
+    } else if (flag & EVENT_FLAG_OR) {
+        match = ((cur_task->event & event_handler->bit_table) != 0);
+    } else {
+        interrupt_enable(level);
+        return ERR_FAIL;
+    }
 
-            ret = cur_task->error;
-        } else {   //cur_task->event & event_handler->event.value == cur_task->event
-            ret = ERR_OK;
+    if (!match) {
+        //no wait time, return timeout
+        if (time == WAIT_NONE) {
+            interrupt_enable(level);
+            return ERR_TIMEOUT;
         }
-    }
 
-    if (flag & EVENT_FLAG_OR) {
-        if (!(cur_task->event & event_handler->bit_table)) {
-            //no wait time, return timeout
-            if (time == WAIT_NONE) {
-                return ERR_TIMEOUT;
-            }
+        //task must not block while holding scheduler lock
+        if (task_sched_locked()) {
+            interrupt_enable(level);
+            return ERR_FAIL;
+        }
 
-            //add current task to pending list
-            pend_list_add(&event_handler->pend_list, cur_task);
-            cur_task->soft_timer.timeout_func = NULL;
-
-            //add software timer
-            if (time != WAIT_FOREVER) {
-                soft_timer_create(&cur_task->soft_timer,
-                                  cur_task->name,
-                                  ipc_timer,
-                                  cur_task,
-                                  time,
-                                  TYPE_ONESHOT);
-                soft_timer_start(&cur_task->soft_timer);
-            }
+        //add current task to pending list
+        pend_list_add(&event_handler->pend_list, cur_task, time);
+        interrupt_enable(level);
 
-            //do schedule
-            task_schedule();
+        //do schedule
+        task_schedule();
 
-            ret = cur_task->error;
-        } else {   //cur_task->event & event_handler->event.value == 1
-            ret = ERR_OK;
-        }
+        level = interrupt_disable();
+        ret = cur_task->error;
     }
 
     if (flag & EVENT_FLAG_CLEAR) {
@@ -476,6 +461,7 @@ err_t event_wait(p_event_t     event_handler,
             event_handler->bit_table &= ~cur_task->event;
         }
     }
+    interrupt_enable(level);
 
     return ret;
 }
@@ -495,39 +481,39 @@ void event_send(p_event_t event_handler,
         return;
     }
 
+    //all waiters are checked in one critical section, so a task cannot see half of the update
+    uint32_t level = interrupt_disable();
     event_handler->bit_table |= event;
 
     p_tcb_t itr, itr_next;
     list_for_each_entry_safe(itr, itr_next, &event_handler->pend_list, list) {
-        if (itr->event_flag & EVENT_FLAG_AND) {
-            if ((itr->event & event_handler->bit_table) == itr->event) {
-                if (itr->soft_timer.timeout_func != NULL) {
-                    soft_timer_stop(&itr->soft_timer);
-                    itr->error = ERR_OK;
-                }
-
-                pend_list_del(itr);
-                continue;
-            }
-        }
-
-        if (itr->event_flag & EVENT_FLAG_OR) {
-            if (itr->event & event_handler->bit_table) {
-                if (itr->soft_timer.timeout_func != NULL) {
-                    soft_timer_stop(&itr->soft_timer);
-                    itr->error = ERR_OK;
-                }
-
-                pend_list_del(itr);
-                continue;
-            }
+        if ((itr->event_flag & EVENT_FLAG_AND) && (itr->event & event_handler->bit_table) == itr->event) {
+            pend_list_del(itr);
+        } else if ((itr->event_flag & EVENT_FLAG_OR) && (itr->event & event_handler->bit_table)) {
+            pend_list_del(itr);
         }
     }
+    interrupt_enable(level);
 
     //do schedule
     task_schedule();
 }
 
+/*
+ * This function is used to send event in interrupt handler, it never blocks.
+ * Input:
+ * event_handler: event handler
+ * evet:          event to send
+ * Output:
+ * none
+ */
+void event_send_from_isr(p_event_t event_handler,
+                         uint32_t  event)
+{
+    //event_send() never blocks, and its reschedule is deferred to os_isr_exit() in interrupt handler
+    event_send(event_handler, event);
+}
+
 /*
  * This function is used to create a message queue.
  * Input:
@@ -546,10 +532,525 @@ err_t msg_queue_create(p_mq_t msg_handler)
     msg_handler->msg_list.prev = &msg_handler->msg_list;
     msg_handler->pend_list.next = &msg_handler->pend_list;
     msg_handler->pend_list.prev = &msg_handler->pend_list;
+    msg_handler->send_list.next = &msg_handler->send_list;
+    msg_handler->send_list.prev = &msg_handler->send_list;
+    msg_handler->pool = NULL;
+    msg_handler->block_pool = NULL;
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to create a message queue over the given storage, messages are copied in and out
+ * of a ring buffer, so send and receive never use heap.
+ * Input:
+ * msg_handler: handler of message queue
+ * pool:        storage of MSG_QUEUE_POOL_SIZE(item_size, capacity) bytes, 4 bytes aligned
+ * item_size:   max size of one message, OS_MSG_ITEM_MAX at most
+ * capacity:    max number of messages in queue
+ * Output:
+ * create result: 0 - ok
+ *                1 - fail
+ */
+err_t msg_queue_create_static(p_mq_t msg_handler,
+                              void *pool,
+                              uint32_t item_size,
+                              uint32_t capacity)
+{
+    if (msg_queue_create(msg_handler) != ERR_OK) {
+        return ERR_FAIL;
+    }
+
+    //messages are copied in critical section, so item size bounds the interrupt latency
+    if (pool == NULL || ((uint32_t)pool & 0x3) || item_size == 0 || item_size > OS_MSG_ITEM_MAX || capacity == 0) {
+        return ERR_FAIL;
+    }
+
+    msg_handler->pool = (uint8_t *)pool;
+    msg_handler->slot_size = ALIGN(item_size, 4) + sizeof(uint32_t);
+    msg_handler->item_size = item_size;
+    msg_handler->capacity = capacity;
+    msg_handler->head = 0;
+    msg_handler->count = 0;
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to create a zero-copy message queue over the given storage.
+ * Buffers are allocated from the queue, and only their pointers are passed from sender to receiver.
+ * Input:
+ * msg_handler: handler of message queue
+ * pool:        storage of MSG_QUEUE_ZC_POOL_SIZE(block_size, block_num) bytes, 4 bytes aligned
+ * block_size:  size of one buffer
+ * block_num:   number of buffers
+ * Output:
+ * create result: 0 - ok
+ *                1 - fail
+ */
+err_t msg_queue_create_zc(p_mq_t msg_handler,
+                          void *pool,
+                          uint32_t block_size,
+                          uint32_t block_num)
+{
+    //pointer queue never gets full, since every queued pointer holds a block
+    if (msg_queue_create_static(msg_handler, pool, sizeof(void *), block_num) != ERR_OK) {
+        return ERR_FAIL;
+    }
+
+    block_size = ALIGN(block_size, 4);
+    if (block_size < sizeof(void *)) {
+        block_size = sizeof(void *);
+    }
+
+    msg_handler->block_state = (uint8_t *)pool + MSG_QUEUE_POOL_SIZE(sizeof(void *), block_num);
+    msg_handler->block_pool = msg_handler->block_state + ALIGN(block_num, 4);
+    msg_handler->block_size = block_size;
+    msg_handler->block_num = block_num;
+
+    //link all blocks into free list
+    uint32_t i;
+    msg_handler->free_block = NULL;
+    for (i = block_num; i > 0; i--) {
+        msg_handler->block_state[i - 1] = BLOCK_FREE;
+        void **block = (void **)(msg_handler->block_pool + (i - 1) * block_size);
+        *block = msg_handler->free_block;
+        msg_handler->free_block = block;
+    }
+
+    return semaphore_create(&msg_handler->block_sem, block_num);
+}
+
+/*
+ * This function is used to get index of the given buffer block in zero-copy message queue.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         buffer block
+ * index:       to store index of buffer block
+ * Output:
+ * result:      0 - ok
+ *              1 - buffer is not a block of this queue
+ */
+static err_t msg_block_index(p_mq_t msg_handler,
+                             void *buf,
+                             uint32_t *index)
+{
+    uint32_t offset = (uint8_t *)buf - msg_handler->block_pool;
+    if ((uint8_t *)buf < msg_handler->block_pool || offset % msg_handler->block_size
+        || offset / msg_handler->block_size >= msg_handler->block_num) {
+        return ERR_FAIL;
+    }
+
+    *index = offset / msg_handler->block_size;
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to allocate a buffer from zero-copy message queue.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         to store address of allocated buffer
+ * time:        wait time if no buffer is free
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ *              2 - timeout
+ */
+err_t msg_queue_alloc(p_mq_t msg_handler,
+                      void **buf,
+                      uint32_t time)
+{
+    if (msg_handler == NULL || buf == NULL || msg_handler->block_pool == NULL) {
+        return ERR_FAIL;
+    }
+
+    err_t ret = semaphore_take(&msg_handler->block_sem, time);
+    if (ret != ERR_OK) {
+        return ret;
+    }
+
+    //semaphore guarantees a free block
+    uint32_t level = interrupt_disable();
+    void **block = (void **)msg_handler->free_block;
+    msg_handler->free_block = *block;
+    msg_handler->block_state[((uint8_t *)block - msg_handler->block_pool) / msg_handler->block_size] = BLOCK_ALLOCATED;
+    interrupt_enable(level);
+
+    *buf = block;
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to post a filled buffer to zero-copy message queue, it belongs to the receiver then.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         buffer allocated by msg_queue_alloc()
+ * urgent:      urgency of message
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ */
+err_t msg_queue_post(p_mq_t msg_handler,
+                     void *buf,
+                     urgency_t urgent)
+{
+    uint32_t index;
+
+    if (msg_handler == NULL || msg_handler->block_pool == NULL || msg_block_index(msg_handler, buf, &index) != ERR_OK) {
+        return ERR_FAIL;
+    }
+
+    //only the owner of an allocated block can post it, and only once
+    uint32_t level = interrupt_disable();
+    if (msg_handler->block_state[index] != BLOCK_ALLOCATED) {
+        interrupt_enable(level);
+        return ERR_FAIL;
+    }
+    msg_handler->block_state[index] = BLOCK_POSTED;
+    interrupt_enable(level);
+
+    err_t ret = msg_queue_send(msg_handler, &buf, sizeof(buf), urgent, WAIT_NONE);
+    if (ret != ERR_OK) {
+        msg_handler->block_state[index] = BLOCK_ALLOCATED;
+    }
+
+    return ret;
+}
+
+/*
+ * This function is used to get a posted buffer from zero-copy message queue, it must be freed after use.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         to store address of received buffer
+ * time:        wait time if message queue is empty
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ *              2 - timeout
+ */
+err_t msg_queue_get(p_mq_t msg_handler,
+                    void **buf,
+                    uint32_t time)
+{
+    if (msg_handler == NULL || buf == NULL || msg_handler->block_pool == NULL) {
+        return ERR_FAIL;
+    }
+
+    err_t ret = msg_queue_recv(msg_handler, buf, sizeof(*buf), time);
+    if (ret == ERR_OK) {
+        uint32_t index;
+        msg_block_index(msg_handler, *buf, &index);
+        //receiver owns the block from now on
+        msg_handler->block_state[index] = BLOCK_ALLOCATED;
+    }
+
+    return ret;
+}
+
+/*
+ * This function is used to give a buffer back to zero-copy message queue.
+ * Input:
+ * msg_handler: handler of zero-copy message queue
+ * buf:         buffer allocated by msg_queue_alloc()
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ */
+err_t msg_queue_free(p_mq_t msg_handler,
+                     void *buf)
+{
+    uint32_t index;
+
+    //only blocks of this queue can be freed
+    if (msg_handler == NULL || msg_handler->block_pool == NULL || msg_block_index(msg_handler, buf, &index) != ERR_OK) {
+        return ERR_FAIL;
+    }
+
+    //a block which is already free or still queued is rejected
+    uint32_t level = interrupt_disable();
+    if (msg_handler->block_state[index] != BLOCK_ALLOCATED) {
+        interrupt_enable(level);
+        return ERR_FAIL;
+    }
+    msg_handler->block_state[index] = BLOCK_FREE;
+    *(void **)buf = msg_handler->free_block;
+    msg_handler->free_block = buf;
+    interrupt_enable(level);
+
+    return semaphore_release(&msg_handler->block_sem);
+}
+
+/*
+ * This function is used to copy a message into ring storage, must be called with interrupt disabled.
+ * Input:
+ * msg_handler: handler of static message queue
+ * buf:         address of send message
+ * size:        size of send message
+ * urgent:      urgency of message
+ * Output:
+ * result:      0 - ok
+ *              1 - message queue is full
+ */
+static err_t msg_ring_put(p_mq_t msg_handler,
+                          void *buf,
+                          uint32_t size,
+                          urgency_t urgent)
+{
+    if (msg_handler->count == msg_handler->capacity) {
+        return ERR_FAIL;
+    }
+
+    uint32_t slot;
+    if (urgent == MSG_NORMAL) {
+        //slot after the last message
+        slot = msg_handler->head + msg_handler->count;
+        if (slot >= msg_handler->capacity) {
+            slot -= msg_handler->capacity;
+        }
+    } else {
+        //slot before the first message
+        slot = (msg_handler->head == 0) ? msg_handler->capacity - 1 : msg_handler->head - 1;
+        msg_handler->head = slot;
+    }
+
+    uint32_t *p_slot = (uint32_t *)(msg_handler->pool + slot * msg_handler->slot_size);
+    *p_slot = size;
+    memcpy(p_slot + 1, buf, size);
+    msg_handler->count++;
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to copy the first message out of ring storage, must be called with interrupt disabled.
+ * Input:
+ * msg_handler: handler of static message queue
+ * buf:         address of receive buffer
+ * size:        size of receive buffer
+ * Output:
+ * result:      0 - ok
+ *              1 - receive buffer is too small
+ *              2 - message queue is empty
+ */
+static err_t msg_ring_get(p_mq_t msg_handler,
+                          void *buf,
+                          uint32_t size)
+{
+    if (msg_handler->count == 0) {
+        return ERR_TIMEOUT;
+    }
+
+    uint32_t *p_slot = (uint32_t *)(msg_handler->pool + msg_handler->head * msg_handler->slot_size);
+    if (*p_slot > size) {
+        return ERR_FAIL;
+    }
+    memcpy(buf, p_slot + 1, *p_slot);
+
+    msg_handler->head++;
+    if (msg_handler->head == msg_handler->capacity) {
+        msg_handler->head = 0;
+    }
+    msg_handler->count--;
 
     return ERR_OK;
 }
 
+/*
+ * This function is used to copy a message to the first waiting receiver and make it ready.
+ * The receiver is claimed in critical section, and the message is copied with interrupt enabled.
+ * Input:
+ * msg_handler: handler of message queue
+ * buf:         address of send message
+ * size:        size of send message
+ * Output:
+ * result:      0 - no receiver is waiting or its buffer is too small
+ *              1 - message is handed over
+ */
+static uint8_t msg_queue_handoff(p_mq_t msg_handler,
+                                 void *buf,
+                                 uint32_t size)
+{
+    p_tcb_t pend_task = NULL;
+
+    uint32_t level = interrupt_disable();
+    if (!list_empty(&msg_handler->pend_list)) {
+        pend_task = list_entry(msg_handler->pend_list.next, typeof(tcb_t), list);
+        if (pend_task->msg_size >= size) {
+            //out of pending list and delay list, no other sender or timeout can reach it
+            list_del(&pend_task->list);
+            task_timeout_stop(pend_task);
+        } else {
+            pend_task = NULL;
+        }
+    }
+    interrupt_enable(level);
+
+    if (pend_task == NULL) {
+        return 0;
+    }
+
+    memcpy(pend_task->msg_buf, buf, size);
+
+    level = interrupt_disable();
+    //NULL buffer tells the receiver that message is delivered
+    pend_task->msg_buf = NULL;
+    pend_task->msg_size = size;
+    pend_task->state = TASK_READY;
+    insert_task_to_list(pend_task);
+    interrupt_enable(level);
+
+    return 1;
+}
+
+/*
+ * This function is used to take the first message of message queue.
+ * Input:
+ * msg_handler: handler of message queue
+ * buf:         address of receive buffer
+ * size:        size of receive buffer
+ * Output:
+ * result:      0 - ok
+ *              1 - receive buffer is too small
+ *              2 - message queue is empty
+ */
+static err_t msg_queue_take(p_mq_t msg_handler,
+                            void *buf,
+                            uint32_t size)
+{
+    uint32_t level = interrupt_disable();
+    if (msg_handler->pool != NULL) {
+        uint8_t wake = 0;
+        err_t ret = msg_ring_get(msg_handler, buf, size);
+        if (ret == ERR_OK && !list_empty(&msg_handler->send_list)) {
+            //a slot is freed, move message of the first blocked sender into it
+            p_tcb_t send_task = list_entry(msg_handler->send_list.next, typeof(tcb_t), list);
+            msg_ring_put(msg_handler, send_task->msg_buf, send_task->msg_size, (urgency_t)send_task->msg_urgent);
+            send_task->msg_buf = NULL;
+            pend_list_del(send_task);
+            wake = 1;
+        }
+        interrupt_enable(level);
+
+        if (wake) {
+            task_schedule();
+        }
+        return ret;
+    }
+
+    if (list_empty(&msg_handler->msg_list)) {
+        interrupt_enable(level);
+        return ERR_TIMEOUT;
+    }
+
+    p_msg_t first_msg = list_entry(msg_handler->msg_list.next, typeof(msg_t), list);
+    if (first_msg->size > size) {
+        interrupt_enable(level);
+        return ERR_FAIL;
+    }
+    list_del(&first_msg->list);
+    interrupt_enable(level);
+
+    memcpy(buf, first_msg->data, first_msg->size);
+    os_free(first_msg->data);
+    first_msg->data = NULL;
+    os_free(first_msg);
+    first_msg = NULL;
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to queue a message into ring storage, and wake the first receiver if any.
+ * Input:
+ * msg_handler: handler of static message queue
+ * buf:         address of send message
+ * size:        size of send message
+ * urgent:      urgency of message
+ * Output:
+ * result:      0 - ok
+ *              1 - message queue is full
+ */
+static err_t msg_queue_put(p_mq_t msg_handler,
+                           void *buf,
+                           uint32_t size,
+                           urgency_t urgent)
+{
+    uint8_t wake = 0;
+
+    uint32_t level = interrupt_disable();
+    err_t ret = msg_ring_put(msg_handler, buf, size, urgent);
+    if (ret == ERR_OK && !list_empty(&msg_handler->pend_list)) {
+        //the first entry of pending list, its buffer is too small for direct copy
+        p_tcb_t pend_task = list_entry(msg_handler->pend_list.next, typeof(tcb_t), list);
+        pend_list_del(pend_task);
+        wake = 1;
+    }
+    interrupt_enable(level);
+
+    if (wake) {
+        task_schedule();
+    }
+
+    return ret;
+}
+
+/*
+ * This function is used to queue a message into ring storage, the sender is blocked while it is full.
+ * Input:
+ * msg_handler: handler of static message queue
+ * buf:         address of send message
+ * size:        size of send message
+ * urgent:      urgency of message
+ * time:        wait time if message queue is full
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ *              2 - timeout
+ */
+static err_t msg_queue_put_wait(p_mq_t msg_handler,
+                                void *buf,
+                                uint32_t size,
+                                urgency_t urgent,
+                                uint32_t time)
+{
+    p_tcb_t cur_task = task_get_self();
+
+    uint32_t level = interrupt_disable();
+    if (msg_queue_put(msg_handler, buf, size, urgent) == ERR_OK) {
+        interrupt_enable(level);
+        return ERR_OK;
+    }
+
+    if (time == WAIT_NONE) {
+        interrupt_enable(level);
+        return ERR_TIMEOUT;
+    }
+
+    //task must not block while holding scheduler lock
+    if (task_sched_locked()) {
+        interrupt_enable(level);
+        return ERR_FAIL;
+    }
+
+    //register message, receiver copies it into the slot it frees
+    cur_task->msg_buf = buf;
+    cur_task->msg_size = size;
+    cur_task->msg_urgent = urgent;
+    pend_list_add(&msg_handler->send_list, cur_task, time);
+    interrupt_enable(level);
+
+    //do schedule
+    task_schedule();
+
+    level = interrupt_disable();
+    cur_task->msg_buf = NULL;
+    interrupt_enable(level);
+
+    return cur_task->error;
+}
+
 /*
  * This function is used to send message at the end of message queue.
  * Input:
@@ -557,19 +1058,36 @@ err_t msg_queue_create(p_mq_t msg_handler)
  * buf:         address of send message
  * size:        size of send message
  * urgent:      urgency of message
+ * time:        wait time if static message queue is full
  * Output:
  * result:      0 - ok
  *              1 - fail
+ *              2 - timeout
  */
 err_t msg_queue_send(p_mq_t msg_handler,
                      void *buf,
                      uint32_t size,
-                     urgency_t urgent)
+                     urgency_t urgent,
+                     uint32_t time)
 {
     if (msg_handler == NULL || buf == NULL) {
         return ERR_FAIL;
     }
 
+    if (msg_handler->pool != NULL && size > msg_handler->item_size) {
+        return ERR_FAIL;
+    }
+
+    //a receiver is waiting, no need to queue the message
+    if (msg_queue_handoff(msg_handler, buf, size)) {
+        task_schedule();
+        return ERR_OK;
+    }
+
+    if (msg_handler->pool != NULL) {
+        return msg_queue_put_wait(msg_handler, buf, size, urgent, time);
+    }
+
     p_msg_t msg = (p_msg_t)os_malloc(sizeof(msg_t));
     if (msg == NULL) {
         return ERR_FAIL;
@@ -586,6 +1104,8 @@ err_t msg_queue_send(p_mq_t msg_handler,
 
     msg->data = data;
     msg->size = size;
+
+    uint32_t level = interrupt_disable();
     if (urgent == MSG_NORMAL) {
         //add to tail of message list
         list_add_before(&msg->list, &msg_handler->msg_list);
@@ -594,18 +1114,16 @@ err_t msg_queue_send(p_mq_t msg_handler,
         list_add_after(&msg->list, &msg_handler->msg_list);
     }
 
-
+    uint8_t wake = 0;
     if (!list_empty(&msg_handler->pend_list)) {
-        //the first entry of pending list
+        //the first entry of pending list, its buffer is too small for direct copy
         p_tcb_t pend_task = list_entry(msg_handler->pend_list.next, typeof(tcb_t), list);
         pend_list_del(pend_task);
+        wake = 1;
+    }
+    interrupt_enable(level);
 
-        //stop soft timer
-        if (pend_task->soft_timer.timeout_func != NULL) {
-            soft_timer_stop(&pend_task->soft_timer);
-            pend_task->error = ERR_OK;
-        }
-
+    if (wake) {
         //do schedule
         task_schedule();
     }
@@ -613,6 +1131,44 @@ err_t msg_queue_send(p_mq_t msg_handler,
     return ERR_OK;
 }
 
+/*
+ * This function is used to send message in interrupt handler, it never blocks or allocates memory.
+ * The message is copied to the buffer of the first waiting receiver directly, otherwise it is queued if the
+ * message queue is created by msg_queue_create_static() and not full, or it fails.
+ * Input:
+ * msg_handler: handler of message queue
+ * buf:         address of send message
+ * size:        size of send message
+ * Output:
+ * result:      0 - ok
+ *              1 - fail
+ */
+err_t msg_queue_send_from_isr(p_mq_t msg_handler,
+                              void *buf,
+                              uint32_t size)
+{
+    if (msg_handler == NULL || buf == NULL) {
+        return ERR_FAIL;
+    }
+
+    if (msg_handler->pool != NULL && size > msg_handler->item_size) {
+        return ERR_FAIL;
+    }
+
+    if (msg_queue_handoff(msg_handler, buf, size)) {
+        //deferred to interrupt exit
+        task_schedule();
+        return ERR_OK;
+    }
+
+    if (msg_handler->pool == NULL) {
+        //no receiver is waiting, and heap cannot be used in interrupt
+        return ERR_FAIL;
+    }
+
+    return msg_queue_put(msg_handler, buf, size, MSG_NORMAL);
+}
+
 /*
  * This function is used to receive message from message queue.
  * Input:
@@ -634,42 +1190,44 @@ err_t msg_queue_recv(p_mq_t msg_handler,
         return ERR_FAIL;
     }
 
-    if (!list_empty(&msg_handler->msg_list)) {
-        p_msg_t first_msg = list_entry(msg_handler->msg_list.next, typeof(msg_t), list);
-        if (first_msg->size > size) {
-            return ERR_FAIL;
-        }
-        memcpy(buf, first_msg->data, first_msg->size);
-
-        list_del(&first_msg->list);
-        os_free(first_msg->data);
-        first_msg->data = NULL;
-        os_free(first_msg);
-        first_msg = NULL;
+    p_tcb_t cur_task = task_get_self();
 
-    } else {   // message queue is empty
+    uint32_t level = interrupt_disable();
+    uint8_t empty = (msg_handler->pool != NULL) ? (msg_handler->count == 0) : list_empty(&msg_handler->msg_list);
+    if (empty) {   // message queue is empty
         if (time == WAIT_NONE) {
+            interrupt_enable(level);
             return ERR_TIMEOUT;
         }
 
-        p_tcb_t cur_task = task_get_self();
-        pend_list_add(&msg_handler->pend_list, cur_task);
-
-        if (time != WAIT_FOREVER) {
-            soft_timer_create(&cur_task->soft_timer,
-                              cur_task->name,
-                              ipc_timer,
-                              cur_task,
-                              time,
-                              TYPE_ONESHOT);
-            soft_timer_start(&cur_task->soft_timer);
+        //task must not block while holding scheduler lock
+        if (task_sched_locked()) {
+            interrupt_enable(level);
+            return ERR_FAIL;
         }
 
+        //register receive buffer, so that sender copies message into it directly
+        cur_task->msg_buf = buf;
+        cur_task->msg_size = size;
+        pend_list_add(&msg_handler->pend_list, cur_task, time);
+        interrupt_enable(level);
+
         //do schedule
         task_schedule();
 
-        return cur_task->error;
+        level = interrupt_disable();
+        err_t ret = cur_task->error;
+        uint8_t delivered = (cur_task->msg_buf == NULL);
+        cur_task->msg_buf = NULL;
+        interrupt_enable(level);
+
+        if (ret != ERR_OK || delivered) {
+            return ret;
+        }
+        //woken up by a queued message which does not fit in the registered buffer
+    } else {
+        interrupt_enable(level);
     }
 
-    return ERR_OK;
+    return msg_queue_take(msg_handler, buf, size);
 }
@@ -0,0 +1,208 @@
+/*
+ * Created by mikePPeng.
+ * This file implements single producer single consumer ring buffer.
+ * Producer only writes head and consumer only writes tail, so data is passed without critical section.
+ * Memory barriers order data against the index which publishes it.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ * Oct 18, 2026   keep the deadline across stale wake-ups
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/ringbuf.h"
+
+/*
+ * This function is used to create a ring buffer over the given storage.
+ * Input:
+ * rb_handler: handler of ring buffer
+ * buf:        storage of ring buffer
+ * size:       size of storage, must be power of 2
+ * threshold:  bytes available to wake up consumer, 0 if consumer never blocks
+ * Output:
+ * create result: 0 - ok
+ *                1 - fail
+ */
+err_t ringbuf_create(p_ringbuf_t rb_handler,
+                     void *buf,
+                     uint32_t size,
+                     uint32_t threshold)
+{
+    if (rb_handler == NULL || buf == NULL || size == 0 || (size & (size - 1)) || threshold > size) {
+        return ERR_FAIL;
+    }
+
+    rb_handler->buf = (uint8_t *)buf;
+    rb_handler->size = size;
+    rb_handler->head = 0;
+    rb_handler->tail = 0;
+    rb_handler->threshold = threshold;
+    rb_handler->waiting = 0;
+
+    return semaphore_create(&rb_handler->sem, 0);
+}
+
+/*
+ * This function is used to write data into ring buffer, it is called by the only producer,
+ * either a task or an interrupt handler wrapped by os_isr_enter() and os_isr_exit().
+ * Input:
+ * rb_handler: handler of ring buffer
+ * data:       data to write
+ * len:        length of data
+ * Output:
+ * number of bytes written, less than @len if ring buffer is full
+ */
+uint32_t ringbuf_put(p_ringbuf_t rb_handler,
+                     const void *data,
+                     uint32_t len)
+{
+    uint32_t head = rb_handler->head;
+    uint32_t tail = rb_handler->tail;
+
+    //consumer has finished reading the space before tail is seen
+    __DMB();
+
+    uint32_t space = rb_handler->size - (head - tail);
+    if (len > space) {
+        len = space;
+    }
+    if (len == 0) {
+        return 0;
+    }
+
+    //copy in two parts if data wraps around the end
+    uint32_t offset = head & (rb_handler->size - 1);
+    uint32_t first = rb_handler->size - offset;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(rb_handler->buf + offset, data, first);
+    memcpy(rb_handler->buf, (const uint8_t *)data + first, len - first);
+
+    //data must be visible before head publishes it
+    __DMB();
+    head += len;
+    rb_handler->head = head;
+
+    if (rb_handler->threshold) {
+        //pairs with the barrier in ringbuf_wait(), either consumer sees new head or producer sees waiting
+        __DMB();
+        if (rb_handler->waiting && head - tail >= rb_handler->threshold) {
+            rb_handler->waiting = 0;
+            semaphore_release_from_isr(&rb_handler->sem);
+        }
+    }
+
+    return len;
+}
+
+/*
+ * This function is used to read data from ring buffer, it is called by the only consumer.
+ * Input:
+ * rb_handler: handler of ring buffer
+ * data:       buffer to store read data
+ * len:        size of buffer
+ * Output:
+ * number of bytes read
+ */
+uint32_t ringbuf_get(p_ringbuf_t rb_handler,
+                     void *data,
+                     uint32_t len)
+{
+    uint32_t tail = rb_handler->tail;
+    uint32_t head = rb_handler->head;
+
+    //data published by head is read only after head is seen
+    __DMB();
+
+    uint32_t count = head - tail;
+    if (len > count) {
+        len = count;
+    }
+    if (len == 0) {
+        return 0;
+    }
+
+    uint32_t offset = tail & (rb_handler->size - 1);
+    uint32_t first = rb_handler->size - offset;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(data, rb_handler->buf + offset, first);
+    memcpy((uint8_t *)data + first, rb_handler->buf, len - first);
+
+    //space is given back only after data is read
+    __DMB();
+    rb_handler->tail = tail + len;
+
+    return len;
+}
+
+/*
+ * This function is used to get number of bytes available to read.
+ * Input:
+ * rb_handler: handler of ring buffer
+ * Output:
+ * number of bytes in ring buffer
+ */
+uint32_t ringbuf_count(p_ringbuf_t rb_handler)
+{
+    return rb_handler->head - rb_handler->tail;
+}
+
+/*
+ * This function is used to block consumer task until threshold bytes are available.
+ * Input:
+ * rb_handler: handler of ring buffer
+ * time:       time in tick to wait
+ * Output:
+ * result:     0 - ok
+ *             1 - fail
+ *             2 - timeout
+ */
+err_t ringbuf_wait(p_ringbuf_t rb_handler,
+                   uint32_t time)
+{
+    if (rb_handler == NULL || rb_handler->threshold == 0) {
+        return ERR_FAIL;
+    }
+
+    //a stale wake-up must not restart the timeout
+    uint32_t deadline = os_tick_get() + time;
+
+    while (1) {
+        //drop a wake-up left from a previous wait which returned without blocking
+        while (semaphore_take(&rb_handler->sem, WAIT_NONE) == ERR_OK) {
+        }
+
+        rb_handler->waiting = 1;
+        __DMB();
+        if (ringbuf_count(rb_handler) >= rb_handler->threshold) {
+            rb_handler->waiting = 0;
+            return ERR_OK;
+        }
+
+        uint32_t remain = WAIT_FOREVER;
+        if (time != WAIT_FOREVER) {
+            remain = deadline - os_tick_get();
+            if ((int32_t)remain <= 0) {
+                rb_handler->waiting = 0;
+                return ERR_TIMEOUT;
+            }
+        }
+
+        //a release landing between the check above and the pend is kept in the semaphore count,
+        //semaphore_take() checks the count and pends in one critical section, so it returns at once then
+        err_t ret = semaphore_take(&rb_handler->sem, remain);
+        rb_handler->waiting = 0;
+
+        //data may have reached the threshold just as the wait timed out
+        if (ringbuf_count(rb_handler) >= rb_handler->threshold) {
+            return ERR_OK;
+        }
+        if (ret != ERR_OK) {
+            return ret;
+        }
+        //woken up by a stale release, wait again for the rest of the time
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for execution time budget.
+ * A greedy task at high priority is limited to 20 ticks of every 100 ticks, so that a lower
+ * priority task still gets the rest of cpu time. Build it with OS_BUDGET set to 1.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "kernel_inc/task.h"
+
+#define GREEDY_BUDGET 20
+#define GREEDY_PERIOD 100
+
+static volatile uint32_t greedy_count = 0;
+static volatile uint32_t worker_count = 0;
+
+static void budget_greedy_entry(void *parameter)
+{
+    while (1) {
+        //never blocks, it would starve lower priority tasks without budget
+        greedy_count++;
+    }
+}
+
+static void budget_worker_entry(void *parameter)
+{
+    while (1) {
+        worker_count++;
+    }
+}
+
+static void budget_report_entry(void *parameter)
+{
+#if OS_BUDGET
+    p_tcb_t greedy = (p_tcb_t)parameter;
+#endif
+    while (1) {
+        task_delay(1000);
+
+        uint32_t greedy_now = greedy_count;
+        uint32_t worker_now = worker_count;
+        greedy_count = 0;
+        worker_count = 0;
+#if OS_BUDGET
+        printf("greedy: %lu, worker: %lu, exhausted %lu times\r\n",
+               greedy_now, worker_now, greedy->budget_exhaust);
+#else
+        printf("greedy: %lu, worker: %lu\r\n", greedy_now, worker_now);
+#endif
+    }
+}
+
+void budget_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    p_tcb_t greedy = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t worker = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t reporter = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(greedy, "greedy", budget_greedy_entry, NULL, 2, 0x300, 0xffffffff);
+    task_create(worker, "worker", budget_worker_entry, NULL, 3, 0x300, 0xffffffff);
+    task_create(reporter, "reporter", budget_report_entry, greedy, 1, 0x500, 0xffffffff);
+
+#if OS_BUDGET
+    task_set_budget(greedy, GREEDY_BUDGET, GREEDY_PERIOD, BUDGET_SUSPEND, 0);
+#endif
+
+    os_start_schedule();
+}
@@ -0,0 +1,51 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for cpu usage accounting and stack usage report.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ * Oct 18, 2026   show stack usage
+ */
+
+#include "kernel_inc/task.h"
+
+static void cpu_busy_entry(void *parameter)
+{
+    volatile uint32_t i;
+    while (1) {
+        //hold cpu for a while, then sleep
+        for (i = 0; i < 0x40000; i++);
+        task_delay(10);
+    }
+}
+
+static void cpu_report_entry(void *parameter)
+{
+    while (1) {
+        task_delay(OS_CPU_USAGE_WINDOW);
+#if OS_CPU_USAGE
+        show_cpu_usage();
+#else
+        printf("cpu usage accounting is disabled in os_config.h\r\n");
+#endif
+#if OS_STACK_CHECK
+        show_stack_usage();
+#endif
+    }
+}
+
+void cpu_usage_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    p_tcb_t busy_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t report_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(busy_task, "busy", cpu_busy_entry, NULL, 2, 0x300, 0xffffffff);
+    task_create(report_task, "report", cpu_report_entry, NULL, 1, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
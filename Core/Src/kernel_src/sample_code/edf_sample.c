@@ -0,0 +1,65 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for earliest deadline first scheduling, OS_EDF has to be enabled in os_config.h.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "kernel_inc/task.h"
+
+#if OS_EDF
+typedef struct edf_job {
+    uint32_t period;
+    uint32_t deadline;
+    uint32_t work;     //busy loop count of each job
+} edf_job_t;
+
+static edf_job_t fast_job = {5, 5, 0x2000};
+static edf_job_t slow_job = {20, 15, 0x8000};
+static p_tcb_t fast_task;
+static p_tcb_t slow_task;
+
+static void edf_job_entry(void *parameter)
+{
+    edf_job_t *job = (edf_job_t *)parameter;
+    volatile uint32_t i;
+
+    task_set_edf(task_get_self(), job->period, job->deadline);
+    while (1) {
+        for (i = 0; i < job->work; i++);
+        task_wait_next_period();
+    }
+}
+
+static void edf_report_entry(void *parameter)
+{
+    while (1) {
+        task_delay(1000);
+        show_task_info(fast_task);
+        show_task_info(slow_task);
+    }
+}
+#endif
+
+void edf_sample_entry(void)
+{
+#if OS_EDF
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    fast_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    slow_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t report_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(fast_task, "edf_fast", edf_job_entry, &fast_job, OS_EDF_PRIO, 0x300, 0xffffffff);
+    task_create(slow_task, "edf_slow", edf_job_entry, &slow_job, OS_EDF_PRIO, 0x300, 0xffffffff);
+    task_create(report_task, "report", edf_report_entry, NULL, OS_EDF_PRIO + 1, 0x500, 0xffffffff);
+
+    os_start_schedule();
+#else
+    printf("edf is disabled in os_config.h!\r\n");
+#endif
+}
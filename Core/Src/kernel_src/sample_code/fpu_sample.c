@@ -0,0 +1,128 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for fpu context switch.
+ * Two tasks ping-pong with semaphores, first with integer only and then with floating point,
+ * cycles of each round trip (two context switches) are measured by DWT cycle counter.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/ipc.h"
+#include "kernel_inc/task.h"
+
+#define ROUND_TRIP_NUM 1000
+
+static sem_t ping_sem;
+static sem_t pong_sem;
+static volatile uint8_t use_float = 0;
+static volatile uint8_t fpu_corrupted = 0;
+
+//integer and float parts are kept in separate functions, so that no fpu instruction is used in integer phase
+static __attribute__((noinline)) uint32_t fpu_ping_integer(void)
+{
+    int i;
+    uint32_t start = DWT->CYCCNT;
+
+    for (i = 0; i < ROUND_TRIP_NUM; i++) {
+        semaphore_release(&pong_sem);
+        semaphore_take(&ping_sem, WAIT_FOREVER);
+    }
+
+    return DWT->CYCCNT - start;
+}
+
+static __attribute__((noinline)) uint32_t fpu_ping_float(void)
+{
+    int i;
+    float acc = 0.0f;
+    uint32_t start = DWT->CYCCNT;
+
+    for (i = 0; i < ROUND_TRIP_NUM; i++) {
+        //@acc is kept in callee-saved fpu registers across the switches
+        acc += 0.5f;
+        semaphore_release(&pong_sem);
+        semaphore_take(&ping_sem, WAIT_FOREVER);
+    }
+
+    uint32_t cycles = DWT->CYCCNT - start;
+    if (acc != ROUND_TRIP_NUM * 0.5f) {
+        fpu_corrupted = 1;
+    }
+
+    return cycles;
+}
+
+static void fpu_ping_entry(void *parameter)
+{
+    uint32_t cycles = fpu_ping_integer();
+    printf("integer tasks: %lu cycles per round trip\r\n", cycles / ROUND_TRIP_NUM);
+
+    use_float = 1;
+    cycles = fpu_ping_float();
+    printf("float tasks: %lu cycles per round trip\r\n", cycles / ROUND_TRIP_NUM);
+
+    if (fpu_corrupted) {
+        printf("fpu context is corrupted!\r\n");
+    } else {
+        printf("fpu context is kept.\r\n");
+    }
+
+    while (1) {
+        task_delay(1000);
+    }
+}
+
+static __attribute__((noinline)) void fpu_pong_float(void)
+{
+    uint32_t n = 0;
+    float acc = 0.0f;
+
+    while (1) {
+        semaphore_take(&pong_sem, WAIT_FOREVER);
+        acc += 0.25f;
+        n++;
+        if (acc != n * 0.25f) {
+            fpu_corrupted = 1;
+        }
+        semaphore_release(&ping_sem);
+    }
+}
+
+static void fpu_pong_entry(void *parameter)
+{
+    while (1) {
+        semaphore_take(&pong_sem, WAIT_FOREVER);
+        if (use_float) {
+            //ping has switched to float phase, this round trip is answered by float loop
+            semaphore_release(&pong_sem);
+            fpu_pong_float();
+        }
+        semaphore_release(&ping_sem);
+    }
+}
+
+void fpu_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    //enable DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    p_tcb_t ping_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t pong_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(ping_task, "fpu_ping", fpu_ping_entry, NULL, 1, 0x500, 0xffffffff);
+    task_create(pong_task, "fpu_pong", fpu_pong_entry, NULL, 2, 0x300, 0xffffffff);
+
+    semaphore_create(&ping_sem, 0);
+    semaphore_create(&pong_sem, 0);
+
+    os_start_schedule();
+}
@@ -0,0 +1,65 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for high resolution timer, a task sleeps 100us repeatedly and
+ * its wake-up jitter in cpu cycle is reported. Build it with OS_HRTIMER set to 1.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "kernel_inc/hrtimer.h"
+#include "kernel_inc/task.h"
+
+#define SAMPLE_PERIOD_US 100
+#define SAMPLE_NUM       10000
+
+static void hrtimer_sampler_entry(void *parameter)
+{
+#if OS_HRTIMER
+    int i;
+    hrtimer_jitter_t jitter;
+
+    while (1) {
+        uint32_t start = hrtimer_now();
+        for (i = 0; i < SAMPLE_NUM; i++) {
+            task_sleep_us(SAMPLE_PERIOD_US);
+        }
+        uint32_t elapsed = hrtimer_now() - start;
+
+        hrtimer_get_jitter(&jitter);
+        printf("%d sleeps of %dus took %luus, jitter min %ld max %ld cycles\r\n",
+               SAMPLE_NUM, SAMPLE_PERIOD_US, elapsed, jitter.min, jitter.max);
+        task_delay(1000);
+    }
+#else
+    printf("high resolution timer is disabled in os_config.h\r\n");
+    while (1) {
+        task_delay(1000);
+    }
+#endif
+}
+
+static void hrtimer_busy_entry(void *parameter)
+{
+    //lower priority load, sampler preempts it on each wake-up
+    volatile uint32_t i;
+    while (1) {
+        i++;
+    }
+}
+
+void hrtimer_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    p_tcb_t sampler = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t busy = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(sampler, "hr_sampler", hrtimer_sampler_entry, NULL, 1, 0x500, 0xffffffff);
+    task_create(busy, "hr_busy", hrtimer_busy_entry, NULL, 3, 0x300, 0xffffffff);
+
+    os_start_schedule();
+}
@@ -0,0 +1,74 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for ipc timeout cost. Two tasks ping-pong with semaphores, first waiting forever
+ * and then with a timeout, cycles of each round trip are measured by DWT cycle counter.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/ipc.h"
+#include "kernel_inc/task.h"
+
+#define ROUND_TRIP_NUM 1000
+
+static sem_t timeout_ping_sem;
+static sem_t timeout_pong_sem;
+static volatile uint32_t timeout_wait_time = WAIT_FOREVER;
+
+static uint32_t timeout_round_trip(uint32_t time)
+{
+    int i;
+    uint32_t start;
+
+    timeout_wait_time = time;
+    start = DWT->CYCCNT;
+    for (i = 0; i < ROUND_TRIP_NUM; i++) {
+        semaphore_release(&timeout_pong_sem);
+        semaphore_take(&timeout_ping_sem, time);
+    }
+
+    return (DWT->CYCCNT - start) / ROUND_TRIP_NUM;
+}
+
+static void timeout_ping_entry(void *parameter)
+{
+    while (1) {
+        printf("wait forever: %lu cycles per round trip\r\n", timeout_round_trip(WAIT_FOREVER));
+        printf("wait 1000 ticks: %lu cycles per round trip\r\n", timeout_round_trip(1000));
+        task_delay(1000);
+    }
+}
+
+static void timeout_pong_entry(void *parameter)
+{
+    while (1) {
+        semaphore_take(&timeout_pong_sem, timeout_wait_time);
+        semaphore_release(&timeout_ping_sem);
+    }
+}
+
+void ipc_timeout_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    //enable DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    p_tcb_t ping_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t pong_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(ping_task, "timeout_ping", timeout_ping_entry, NULL, 1, 0x500, 0xffffffff);
+    task_create(pong_task, "timeout_pong", timeout_pong_entry, NULL, 2, 0x300, 0xffffffff);
+
+    semaphore_create(&timeout_ping_sem, 0);
+    semaphore_create(&timeout_pong_sem, 0);
+
+    os_start_schedule();
+}
@@ -0,0 +1,116 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for interrupt latency above and below kernel priority ceiling.
+ * TIM6 interrupt runs above OS_KERNEL_IRQ_PRIO and TIM7 interrupt runs at it, while two tasks ping-pong
+ * with semaphores to keep kernel in critical sections. Latency is the timer count read at the start of
+ * each update interrupt, the worst case is reported in cpu cycles. Build it with OS_SAMPLE_IRQ_LATENCY set to 1.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ * Oct 18, 2026   build interrupt handlers only if enabled in os_config.h
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/ipc.h"
+#include "kernel_inc/task.h"
+
+#if OS_SAMPLE_IRQ_LATENCY
+#define LATENCY_HIGH_PRIO (OS_KERNEL_IRQ_PRIO - 4)
+#define LATENCY_LOW_PRIO  OS_KERNEL_IRQ_PRIO
+
+static sem_t latency_ping_sem;
+static sem_t latency_pong_sem;
+static volatile uint32_t latency_high_max = 0;
+static volatile uint32_t latency_low_max = 0;
+
+void TIM6_DAC_IRQHandler(void)
+{
+    uint32_t count = TIM6->CNT;
+    TIM6->SR = 0;
+    if (count > latency_high_max) {
+        latency_high_max = count;
+    }
+}
+
+void TIM7_IRQHandler(void)
+{
+    uint32_t count = TIM7->CNT;
+    TIM7->SR = 0;
+    if (count > latency_low_max) {
+        latency_low_max = count;
+    }
+}
+
+static void latency_timer_start(TIM_TypeDef *tim,
+                                IRQn_Type irq,
+                                uint32_t prio,
+                                uint32_t period)
+{
+    //count at timer clock without prescaler
+    tim->PSC = 0;
+    tim->ARR = period;
+    tim->EGR = TIM_EGR_UG;
+    tim->SR = 0;
+    tim->DIER = TIM_DIER_UIE;
+    HAL_NVIC_SetPriority(irq, prio, 0);
+    HAL_NVIC_EnableIRQ(irq);
+    tim->CR1 = TIM_CR1_CEN;
+}
+
+static void latency_ping_entry(void *parameter)
+{
+    //timer clock is twice of PCLK1 since APB1 is divided
+    uint32_t cycles_per_count = SystemCoreClock / (HAL_RCC_GetPCLK1Freq() * 2);
+
+    while (1) {
+        uint32_t start = os_tick_get();
+        while (os_tick_get() - start < 1000) {
+            semaphore_release(&latency_pong_sem);
+            semaphore_take(&latency_ping_sem, 100);
+        }
+
+        printf("worst latency above ceiling: %lu cycles, at ceiling: %lu cycles\r\n",
+               latency_high_max * cycles_per_count, latency_low_max * cycles_per_count);
+        latency_high_max = 0;
+        latency_low_max = 0;
+    }
+}
+
+static void latency_pong_entry(void *parameter)
+{
+    while (1) {
+        semaphore_take(&latency_pong_sem, WAIT_FOREVER);
+        semaphore_release(&latency_ping_sem);
+    }
+}
+
+#endif
+
+void irq_latency_sample_entry(void)
+{
+#if OS_SAMPLE_IRQ_LATENCY
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    p_tcb_t ping_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t pong_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(ping_task, "latency_ping", latency_ping_entry, NULL, 1, 0x500, 0xffffffff);
+    task_create(pong_task, "latency_pong", latency_pong_entry, NULL, 2, 0x300, 0xffffffff);
+
+    semaphore_create(&latency_ping_sem, 0);
+    semaphore_create(&latency_pong_sem, 0);
+
+    //periods are co-prime, so that interrupts hit kernel code at different points
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    __HAL_RCC_TIM7_CLK_ENABLE();
+    latency_timer_start(TIM6, TIM6_DAC_IRQn, LATENCY_HIGH_PRIO, 9973);
+    latency_timer_start(TIM7, TIM7_IRQn, LATENCY_LOW_PRIO, 10007);
+
+    os_start_schedule();
+#else
+    printf("interrupt latency sample is disabled in os_config.h\r\n");
+#endif
+}
@@ -0,0 +1,123 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for kernel APIs called in interrupt handler.
+ * EXTI line 0 is triggered by software, its handler wakes three tasks by semaphore, event and message,
+ * while only one PendSV is requested at interrupt exit. Latency from trigger to the highest waiter is measured by DWT.
+ * Build it with OS_SAMPLE_ISR set to 1.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ * Oct 18, 2026   build interrupt handler only if enabled in os_config.h
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/ipc.h"
+#include "kernel_inc/task.h"
+
+#if OS_SAMPLE_ISR
+#define ISR_EVENT_BIT 0x01
+
+static sem_t isr_sem;
+static event_t isr_event;
+static mq_t isr_mq;
+static volatile uint32_t isr_trigger_cycle = 0;
+static volatile uint32_t isr_msg_fail = 0;
+
+void EXTI0_IRQHandler(void)
+{
+    os_isr_enter();
+
+    EXTI->PR = EXTI_PR_PR0;
+
+    uint32_t stamp = isr_trigger_cycle;
+    semaphore_release_from_isr(&isr_sem);
+    event_send_from_isr(&isr_event, ISR_EVENT_BIT);
+    if (msg_queue_send_from_isr(&isr_mq, &stamp, sizeof(stamp)) != ERR_OK) {
+        //receiver is not waiting, message is dropped instead of allocated
+        isr_msg_fail++;
+    }
+
+    os_isr_exit();
+}
+
+static void isr_sem_entry(void *parameter)
+{
+    uint32_t n = 0;
+    uint32_t latency_max = 0;
+
+    while (1) {
+        semaphore_take(&isr_sem, WAIT_FOREVER);
+
+        uint32_t latency = DWT->CYCCNT - isr_trigger_cycle;
+        if (latency > latency_max) {
+            latency_max = latency;
+        }
+        if (++n % 100 == 0) {
+            printf("isr to task: %lu cycles, max %lu, %lu messages dropped\r\n", latency, latency_max, isr_msg_fail);
+        }
+    }
+}
+
+static void isr_event_entry(void *parameter)
+{
+    event_add(ISR_EVENT_BIT);
+    while (1) {
+        event_wait(&isr_event, EVENT_FLAG_OR | EVENT_FLAG_CLEAR, WAIT_FOREVER);
+    }
+}
+
+static void isr_mq_entry(void *parameter)
+{
+    uint32_t stamp;
+    while (1) {
+        msg_queue_recv(&isr_mq, &stamp, sizeof(stamp), WAIT_FOREVER);
+    }
+}
+
+static void isr_trigger_entry(void *parameter)
+{
+    while (1) {
+        task_delay(10);
+        isr_trigger_cycle = DWT->CYCCNT;
+        EXTI->SWIER = EXTI_SWIER_SWIER0;
+    }
+}
+
+#endif
+
+void isr_sample_entry(void)
+{
+#if OS_SAMPLE_ISR
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    //enable DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    //software triggered EXTI line 0, at the highest priority allowed to call kernel APIs
+    EXTI->IMR |= EXTI_IMR_MR0;
+    HAL_NVIC_SetPriority(EXTI0_IRQn, OS_KERNEL_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(EXTI0_IRQn);
+
+    semaphore_create(&isr_sem, 0);
+    event_create(&isr_event);
+    msg_queue_create(&isr_mq);
+
+    p_tcb_t sem_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t event_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t mq_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t trigger_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(sem_task, "isr_sem", isr_sem_entry, NULL, 2, 0x500, 0xffffffff);
+    task_create(event_task, "isr_event", isr_event_entry, NULL, 3, 0x300, 0xffffffff);
+    task_create(mq_task, "isr_mq", isr_mq_entry, NULL, 3, 0x300, 0xffffffff);
+    task_create(trigger_task, "isr_trigger", isr_trigger_entry, NULL, 4, 0x300, 0xffffffff);
+
+    os_start_schedule();
+#else
+    printf("interrupt ipc sample is disabled in os_config.h\r\n");
+#endif
+}
@@ -0,0 +1,59 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for blocking send of static message queue.
+ * A fast producer is throttled by a slow consumer through a queue of 4 messages,
+ * the producer only gets ahead by the queue capacity and heap usage stays constant.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "kernel_inc/ipc.h"
+#include "kernel_inc/task.h"
+
+#define BP_QUEUE_LEN 4
+
+static mq_t bp_mq;
+static uint32_t bp_mq_pool[MSG_QUEUE_POOL_SIZE(sizeof(uint32_t), BP_QUEUE_LEN) / sizeof(uint32_t)];
+static volatile uint32_t bp_sent = 0;
+
+static void bp_producer_entry(void *parameter)
+{
+    uint32_t seq = 0;
+    while (1) {
+        //blocks while the queue is full
+        if (msg_queue_send(&bp_mq, &seq, sizeof(seq), MSG_NORMAL, WAIT_FOREVER) == ERR_OK) {
+            seq++;
+            bp_sent = seq;
+        }
+    }
+}
+
+static void bp_consumer_entry(void *parameter)
+{
+    uint32_t seq;
+    while (1) {
+        task_delay(100);
+        if (msg_queue_recv(&bp_mq, &seq, sizeof(seq), WAIT_FOREVER) == ERR_OK) {
+            printf("received %lu, producer has sent %lu\r\n", seq, bp_sent);
+        }
+    }
+}
+
+void mq_backpressure_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    msg_queue_create_static(&bp_mq, bp_mq_pool, sizeof(uint32_t), BP_QUEUE_LEN);
+
+    p_tcb_t producer = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t consumer = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(producer, "bp_producer", bp_producer_entry, NULL, 3, 0x300, 0xffffffff);
+    task_create(consumer, "bp_consumer", bp_consumer_entry, NULL, 2, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
@@ -0,0 +1,77 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for message queue throughput. Batches of messages are sent and then received
+ * by one task, through a heap message queue and through a static message queue,
+ * cycles of each send and receive pair are measured by DWT cycle counter.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/ipc.h"
+#include "kernel_inc/task.h"
+
+#define MQ_ITEM_SIZE 16
+#define MQ_BATCH     8
+#define MQ_ROUND_NUM 1000
+
+static mq_t heap_mq;
+static mq_t static_mq;
+static uint32_t static_mq_pool[MSG_QUEUE_POOL_SIZE(MQ_ITEM_SIZE, MQ_BATCH) / sizeof(uint32_t)];
+
+static uint32_t mq_measure(p_mq_t mq)
+{
+    int i, j;
+    uint8_t msg[MQ_ITEM_SIZE] = {0};
+    uint32_t start = DWT->CYCCNT;
+
+    for (i = 0; i < MQ_ROUND_NUM; i++) {
+        for (j = 0; j < MQ_BATCH; j++) {
+            msg[0] = j;
+            if (msg_queue_send(mq, msg, sizeof(msg), MSG_NORMAL, WAIT_NONE) != ERR_OK) {
+                printf("send failed!\r\n");
+            }
+        }
+        for (j = 0; j < MQ_BATCH; j++) {
+            if (msg_queue_recv(mq, msg, sizeof(msg), WAIT_NONE) != ERR_OK || msg[0] != j) {
+                printf("receive failed!\r\n");
+            }
+        }
+    }
+
+    return DWT->CYCCNT - start;
+}
+
+static void mq_bench_entry(void *parameter)
+{
+    uint32_t cycles = mq_measure(&heap_mq);
+    printf("heap message queue: %lu cycles per message\r\n", cycles / (MQ_ROUND_NUM * MQ_BATCH));
+
+    cycles = mq_measure(&static_mq);
+    printf("static message queue: %lu cycles per message\r\n", cycles / (MQ_ROUND_NUM * MQ_BATCH));
+
+    while (1) {
+        task_delay(1000);
+    }
+}
+
+void mq_static_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    //enable DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    msg_queue_create(&heap_mq);
+    msg_queue_create_static(&static_mq, static_mq_pool, MQ_ITEM_SIZE, MQ_BATCH);
+
+    p_tcb_t bench_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    task_create(bench_task, "mq_bench", mq_bench_entry, NULL, 1, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
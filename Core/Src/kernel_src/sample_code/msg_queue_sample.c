@@ -19,11 +19,11 @@ void msg_send_entry(void *parameter)
         //after four normal message, send one urgent messsage
         if (i++ % 5 != 0) {
             char msg1[MSG_SIZE] = "This is a normal message.\r\n";
-            msg_queue_send(&msg_queue, msg1, MSG_SIZE, MSG_NORMAL);
+            msg_queue_send(&msg_queue, msg1, MSG_SIZE, MSG_NORMAL, WAIT_FOREVER);
             task_delay(1000);
         } else {
             char msg2[MSG_SIZE] = "This is an urgent message!\r\n";
-            msg_queue_send(&msg_queue, msg2, MSG_SIZE, MSG_URGENT);
+            msg_queue_send(&msg_queue, msg2, MSG_SIZE, MSG_URGENT, WAIT_FOREVER);
             task_delay(1000);
         }
     }
@@ -0,0 +1,88 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for direct to task notification.
+ * Two tasks ping-pong first with semaphores and then with notifications,
+ * cycles of each round trip (two context switches) are measured by DWT cycle counter.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/ipc.h"
+#include "kernel_inc/task.h"
+
+#define ROUND_TRIP_NUM 1000
+
+static sem_t notify_ping_sem;
+static sem_t notify_pong_sem;
+static p_tcb_t notify_ping_task;
+static p_tcb_t notify_pong_task;
+static volatile uint8_t use_notify = 0;
+
+static void notify_ping_entry(void *parameter)
+{
+    int i;
+
+    uint32_t start = DWT->CYCCNT;
+    for (i = 0; i < ROUND_TRIP_NUM; i++) {
+        semaphore_release(&notify_pong_sem);
+        semaphore_take(&notify_ping_sem, WAIT_FOREVER);
+    }
+    uint32_t sem_cycles = DWT->CYCCNT - start;
+
+    //pong leaves semaphore loop after this release
+    use_notify = 1;
+    semaphore_release(&notify_pong_sem);
+    semaphore_take(&notify_ping_sem, WAIT_FOREVER);
+
+    start = DWT->CYCCNT;
+    for (i = 0; i < ROUND_TRIP_NUM; i++) {
+        task_notify(notify_pong_task, 0, NOTIFY_INCREMENT);
+        task_notify_wait(0xFFFFFFFF, NULL, WAIT_FOREVER);
+    }
+    uint32_t notify_cycles = DWT->CYCCNT - start;
+
+    printf("semaphore: %lu cycles per round trip\r\n", sem_cycles / ROUND_TRIP_NUM);
+    printf("notification: %lu cycles per round trip\r\n", notify_cycles / ROUND_TRIP_NUM);
+
+    while (1) {
+        task_delay(1000);
+    }
+}
+
+static void notify_pong_entry(void *parameter)
+{
+    while (!use_notify) {
+        semaphore_take(&notify_pong_sem, WAIT_FOREVER);
+        semaphore_release(&notify_ping_sem);
+    }
+
+    while (1) {
+        task_notify_wait(0xFFFFFFFF, NULL, WAIT_FOREVER);
+        task_notify(notify_ping_task, 0, NOTIFY_INCREMENT);
+    }
+}
+
+void notify_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    //enable DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    notify_ping_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    notify_pong_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(notify_ping_task, "notify_ping", notify_ping_entry, NULL, 1, 0x500, 0xffffffff);
+    task_create(notify_pong_task, "notify_pong", notify_pong_entry, NULL, 2, 0x300, 0xffffffff);
+
+    semaphore_create(&notify_ping_sem, 0);
+    semaphore_create(&notify_pong_sem, 0);
+
+    os_start_schedule();
+}
@@ -0,0 +1,49 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for drift-free periodic task.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "kernel_inc/task.h"
+
+#define CONTROL_PERIOD 1
+
+static p_tcb_t control_task;
+
+static void periodic_control_entry(void *parameter)
+{
+    volatile uint32_t i;
+    uint32_t last_wake = os_tick_get();
+
+    while (1) {
+        //control loop body, its execution time does not shift the next release
+        for (i = 0; i < 0x1000; i++);
+        task_delay_until(&last_wake, CONTROL_PERIOD);
+    }
+}
+
+static void periodic_report_entry(void *parameter)
+{
+    while (1) {
+        task_delay(1000);
+        show_task_info(control_task);
+    }
+}
+
+void periodic_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    control_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t report_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(control_task, "control", periodic_control_entry, NULL, 1, 0x300, 0xffffffff);
+    task_create(report_task, "report", periodic_report_entry, NULL, 2, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
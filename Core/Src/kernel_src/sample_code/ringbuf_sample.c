@@ -0,0 +1,108 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for single producer single consumer ring buffer.
+ * TIM4 update interrupt pushes a 16-bit sample at 100 kHz, the consumer task is woken up once
+ * per 256 bytes and checks that samples arrive in sequence. Build it with OS_SAMPLE_RINGBUF set to 1.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ * Oct 18, 2026   build interrupt handler only if enabled in os_config.h
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/ringbuf.h"
+#include "kernel_inc/task.h"
+
+#if OS_SAMPLE_RINGBUF
+#define RB_SIZE       1024
+#define RB_THRESHOLD  256
+#define RB_SAMPLE_HZ  100000
+
+static ringbuf_t sample_rb;
+static uint8_t sample_rb_buf[RB_SIZE];
+static volatile uint32_t rb_overflow = 0;
+
+void TIM4_IRQHandler(void)
+{
+    static uint16_t sample = 0;
+
+    os_isr_enter();
+
+    TIM4->SR = 0;
+    if (ringbuf_put(&sample_rb, &sample, sizeof(sample)) == sizeof(sample)) {
+        sample++;
+    } else {
+        rb_overflow++;
+    }
+
+    os_isr_exit();
+}
+
+static void rb_consumer_entry(void *parameter)
+{
+    uint16_t batch[RB_THRESHOLD / sizeof(uint16_t)];
+    uint16_t expect = 0;
+    uint32_t wakeups = 0;
+    uint32_t bytes = 0;
+    uint32_t errors = 0;
+    uint32_t last_tick = os_tick_get();
+
+    while (1) {
+        if (ringbuf_wait(&sample_rb, 100) != ERR_OK) {
+            printf("no data!\r\n");
+            continue;
+        }
+        wakeups++;
+
+        uint32_t len = ringbuf_get(&sample_rb, batch, sizeof(batch));
+        uint32_t i;
+        for (i = 0; i < len / sizeof(uint16_t); i++) {
+            if (batch[i] != expect) {
+                errors++;
+                expect = batch[i];
+            }
+            expect++;
+        }
+        bytes += len;
+
+        if (os_tick_get() - last_tick >= 1000) {
+            printf("%lu bytes/s in %lu wake-ups, %lu sequence errors, %lu overflows\r\n",
+                   bytes, wakeups, errors, rb_overflow);
+            wakeups = 0;
+            bytes = 0;
+            last_tick = os_tick_get();
+        }
+    }
+}
+
+#endif
+
+void ringbuf_sample_entry(void)
+{
+#if OS_SAMPLE_RINGBUF
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    ringbuf_create(&sample_rb, sample_rb_buf, RB_SIZE, RB_THRESHOLD);
+
+    p_tcb_t consumer = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    task_create(consumer, "rb_consumer", rb_consumer_entry, NULL, 1, 0x600, 0xffffffff);
+
+    //timer clock is twice of PCLK1 since APB1 is divided
+    __HAL_RCC_TIM4_CLK_ENABLE();
+    TIM4->PSC = 0;
+    TIM4->ARR = HAL_RCC_GetPCLK1Freq() * 2 / RB_SAMPLE_HZ - 1;
+    TIM4->EGR = TIM_EGR_UG;
+    TIM4->SR = 0;
+    TIM4->DIER = TIM_DIER_UIE;
+    HAL_NVIC_SetPriority(TIM4_IRQn, OS_KERNEL_IRQ_PRIO, 0);
+    HAL_NVIC_EnableIRQ(TIM4_IRQn);
+    TIM4->CR1 = TIM_CR1_CEN;
+
+    os_start_schedule();
+#else
+    printf("ring buffer sample is disabled in os_config.h\r\n");
+#endif
+}
@@ -22,8 +22,8 @@ void timeout_func(void *parameter)
     int num = *(int *)parameter;
     if (num == 1) {
         printf("this is timer1!\r\n");
-        soft_timer_create(&timer2, "timer2", timeout_func, &t2, 1000, TYPE_REPEAT);
-        soft_timer_create(&timer3, "timer3", timeout_func, &t3, 2000, TYPE_REPEAT);
+        soft_timer_create(&timer2, "timer2", timeout_func, &t2, 1000, 0, TYPE_REPEAT);
+        soft_timer_create(&timer3, "timer3", timeout_func, &t3, 2000, 0, TYPE_REPEAT);
         soft_timer_start(&timer2);
         soft_timer_start(&timer3);
     }
@@ -42,7 +42,7 @@ void soft_timer_sample_entry(void)
         return;
     }
 
-    soft_timer_create(&timer1, "timer1", timeout_func, &t1, 1000, TYPE_ONESHOT);
+    soft_timer_create(&timer1, "timer1", timeout_func, &t1, 1000, 0, TYPE_ONESHOT);
     soft_timer_start(&timer1);
 
     os_start_schedule();
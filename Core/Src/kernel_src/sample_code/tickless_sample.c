@@ -0,0 +1,62 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for tickless idle, it reports wake-ups per second.
+ * Build it with OS_TICKLESS_IDLE set to 0 and 1 to compare.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "kernel_inc/task.h"
+#include "kernel_inc/tickless.h"
+
+#define REPORT_PERIOD 5000
+
+static void tickless_sleeper_entry(void *parameter)
+{
+    uint32_t period = *(uint32_t *)parameter;
+    while (1) {
+        task_delay(period);
+    }
+}
+
+static void tickless_report_entry(void *parameter)
+{
+    uint32_t last_wakeups = tickless_get_wakeups();
+    uint32_t last_tick = os_tick_get();
+    while (1) {
+        task_delay(REPORT_PERIOD);
+
+        uint32_t tick = os_tick_get();
+#if OS_TICKLESS_IDLE
+        uint32_t wakeups = tickless_get_wakeups();
+#else
+        //without tickless idle, cpu is interrupted by every tick
+        uint32_t wakeups = last_wakeups + (tick - last_tick);
+#endif
+        printf("%lu wake-ups per second\r\n", (wakeups - last_wakeups) * 1000 / (tick - last_tick));
+        last_wakeups = wakeups;
+        last_tick = tick;
+    }
+}
+
+void tickless_sample_entry(void)
+{
+    static uint32_t period1 = 1000;
+    static uint32_t period2 = 3000;
+
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    p_tcb_t sleeper1 = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t sleeper2 = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    p_tcb_t reporter = (p_tcb_t)os_malloc(sizeof(tcb_t));
+
+    task_create(sleeper1, "sleeper1", tickless_sleeper_entry, &period1, 2, 0x300, 0xffffffff);
+    task_create(sleeper2, "sleeper2", tickless_sleeper_entry, &period2, 2, 0x300, 0xffffffff);
+    task_create(reporter, "reporter", tickless_report_entry, NULL, 1, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
@@ -0,0 +1,54 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for 64-bit tick and nanosecond time.
+ * Time is read in a tight loop to check it never goes backwards, and the cost of one read is measured.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/task.h"
+
+#define TIME_READ_NUM 100000
+
+static void time_check_entry(void *parameter)
+{
+    int i;
+    while (1) {
+        uint32_t backwards = 0;
+        uint64_t last = os_time_ns();
+        uint32_t start = DWT->CYCCNT;
+        for (i = 0; i < TIME_READ_NUM; i++) {
+            uint64_t now = os_time_ns();
+            if (now < last) {
+                backwards++;
+            }
+            last = now;
+        }
+        uint32_t cycles = DWT->CYCCNT - start;
+
+        printf("tick %lu, time %lu us, %lu cycles per read, %lu backwards\r\n",
+               (uint32_t)os_tick_get64(), (uint32_t)(last / 1000), cycles / TIME_READ_NUM, backwards);
+        HAL_Delay(500);
+        task_delay(500);
+    }
+}
+
+void time_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    //enable DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    p_tcb_t check_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    task_create(check_task, "time_check", time_check_entry, NULL, 1, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
@@ -0,0 +1,61 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for timers expiring in the same tick.
+ * A burst of timers share one deadline, ticks between the first and the last callback are reported.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "kernel_inc/soft_timer.h"
+#include "kernel_inc/task.h"
+
+#define BURST_TIMER_NUM 20
+
+static soft_timer_t burst_timers[BURST_TIMER_NUM];
+static volatile uint32_t burst_fired = 0;
+static volatile uint32_t burst_first_tick = 0;
+static volatile uint32_t burst_last_tick = 0;
+
+static void burst_timeout_func(void *parameter)
+{
+    uint32_t tick = os_tick_get();
+    if (burst_fired == 0) {
+        burst_first_tick = tick;
+    }
+    burst_last_tick = tick;
+    burst_fired++;
+}
+
+static void burst_report_entry(void *parameter)
+{
+    int i;
+    while (1) {
+        burst_fired = 0;
+        for (i = 0; i < BURST_TIMER_NUM; i++) {
+            soft_timer_start(&burst_timers[i]);
+        }
+
+        task_delay(500);
+        printf("%lu timers fired within %lu ticks\r\n", burst_fired, burst_last_tick - burst_first_tick);
+    }
+}
+
+void timer_burst_sample_entry(void)
+{
+    int i;
+
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    for (i = 0; i < BURST_TIMER_NUM; i++) {
+        soft_timer_create(&burst_timers[i], "burst", burst_timeout_func, NULL, 100, 0, TYPE_ONESHOT);
+    }
+
+    p_tcb_t report_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    task_create(report_task, "burst_report", burst_report_entry, NULL, 1, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
@@ -0,0 +1,62 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for timer slack. Several repeat timers with unrelated periods are started,
+ * and the number of distinct ticks in which they fire is reported. Change TIMER_SLACK to 0 to compare.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "kernel_inc/soft_timer.h"
+#include "kernel_inc/task.h"
+
+#define SLACK_TIMER_NUM 4
+#define TIMER_SLACK     50
+
+static const uint32_t slack_periods[SLACK_TIMER_NUM] = {100, 130, 170, 250};
+static soft_timer_t slack_timers[SLACK_TIMER_NUM];
+static volatile uint32_t slack_fired = 0;
+static volatile uint32_t slack_wake_ticks = 0;
+static volatile uint32_t slack_last_tick = 0;
+
+static void slack_timeout_func(void *parameter)
+{
+    uint32_t tick = os_tick_get();
+    if (slack_wake_ticks == 0 || tick != slack_last_tick) {
+        //first timer fired in this tick
+        slack_wake_ticks++;
+        slack_last_tick = tick;
+    }
+    slack_fired++;
+}
+
+static void slack_report_entry(void *parameter)
+{
+    while (1) {
+        slack_fired = 0;
+        slack_wake_ticks = 0;
+        task_delay(10000);
+        printf("%lu timeouts in %lu ticks\r\n", slack_fired, slack_wake_ticks);
+    }
+}
+
+void timer_slack_sample_entry(void)
+{
+    int i;
+
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    for (i = 0; i < SLACK_TIMER_NUM; i++) {
+        soft_timer_create(&slack_timers[i], "slack", slack_timeout_func, NULL,
+                          slack_periods[i], TIMER_SLACK, TYPE_REPEAT);
+        soft_timer_start(&slack_timers[i]);
+    }
+
+    p_tcb_t report_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    task_create(report_task, "slack_report", slack_report_entry, NULL, 2, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
@@ -0,0 +1,84 @@
+/*
+ * Created by mikePPeng.
+ * This is sample code for software timer start/stop cost.
+ * Cycles of starting and stopping one timer are measured by DWT cycle counter,
+ * with different number of timers already started.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/soft_timer.h"
+#include "kernel_inc/task.h"
+
+#define BENCH_TIMER_MAX 1024
+#define BENCH_ROUND     100
+
+static soft_timer_t bench_timers[BENCH_TIMER_MAX];
+static soft_timer_t probe_timer;
+
+static void bench_timeout_func(void *parameter)
+{
+}
+
+static void wheel_bench_entry(void *parameter)
+{
+    static const uint32_t timer_nums[] = {0, 16, 128, 1024};
+    uint32_t started = 0;
+    int i, j;
+
+    for (i = 0; i < sizeof(timer_nums) / sizeof(timer_nums[0]); i++) {
+        //background timers are spread over a long range, none of them expires during the test
+        while (started < timer_nums[i]) {
+            soft_timer_create(&bench_timers[started], "bench", bench_timeout_func, NULL,
+                              100000 + started * 37, 0, TYPE_ONESHOT);
+            soft_timer_start(&bench_timers[started]);
+            started++;
+        }
+
+        uint32_t start_cycles = 0;
+        uint32_t stop_cycles = 0;
+        for (j = 0; j < BENCH_ROUND; j++) {
+            soft_timer_create(&probe_timer, "probe", bench_timeout_func, NULL, 100000 + j * 53, 0, TYPE_ONESHOT);
+
+            uint32_t t0 = DWT->CYCCNT;
+            soft_timer_start(&probe_timer);
+            uint32_t t1 = DWT->CYCCNT;
+            soft_timer_stop(&probe_timer);
+            uint32_t t2 = DWT->CYCCNT;
+
+            start_cycles += t1 - t0;
+            stop_cycles += t2 - t1;
+        }
+
+        printf("%lu timers: start %lu cycles, stop %lu cycles\r\n",
+               started, start_cycles / BENCH_ROUND, stop_cycles / BENCH_ROUND);
+    }
+
+    for (i = 0; i < started; i++) {
+        soft_timer_stop(&bench_timers[i]);
+    }
+
+    while (1) {
+        task_delay(1000);
+    }
+}
+
+void timer_wheel_sample_entry(void)
+{
+    if (heap_init() != ERR_OK) {
+        printf("heap init failed!\r\n");
+        return;
+    }
+
+    //enable DWT cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    p_tcb_t bench_task = (p_tcb_t)os_malloc(sizeof(tcb_t));
+    task_create(bench_task, "wheel_bench", wheel_bench_entry, NULL, 1, 0x500, 0xffffffff);
+
+    os_start_schedule();
+}
@@ -1,14 +1,178 @@
 /*
  * Created by mikePPeng.
  * This file implements software timer related APIs.
+ * Started timers are kept in a hierarchical timing wheel, so that start and stop are O(1).
  * Change Logs:
  * Date           Notes
  * Mar 9, 2021   the first version
+ * Oct 18, 2026  add tickless idle support
+ * Oct 18, 2026  replace delta list with hierarchical timing wheel
+ * Oct 18, 2026  expire all timers of a tick in one batch
+ * Oct 18, 2026  add timer service task
+ * Oct 18, 2026  add timer slack
  */
 
+#include "kernel_inc/interrupt.h"
+#include "kernel_inc/ipc.h"
 #include "kernel_inc/soft_timer.h"
 
-list_head_init(g_timer_list_head);
+//each level of the wheel has 2^WHEEL_BITS slots, a slot of level n covers 2^(WHEEL_BITS * n) ticks
+#define WHEEL_BITS   5
+#define WHEEL_SIZE   (1U << WHEEL_BITS)
+#define WHEEL_MASK   (WHEEL_SIZE - 1)
+#define WHEEL_LEVEL  6
+#define WHEEL_SPAN   (1U << (WHEEL_BITS * WHEEL_LEVEL))   //ticks covered by all levels
+
+#define LEVEL_SHIFT(level) (WHEEL_BITS * (level))
+#define SLOT_BIT(slot)     (1U << (slot))
+
+static struct list_head g_timer_wheel[WHEEL_LEVEL][WHEEL_SIZE];
+static uint32_t g_timer_bitmap[WHEEL_LEVEL];   //bit n is set if slot n of the level is not empty
+static uint32_t g_timer_tick = 0;              //the next tick to be checked
+static uint8_t g_timer_inited = 0;
+
+#if OS_TIMER_TASK
+list_head_init(g_timer_expired_list);   //expired timers whose timeout function is not called yet
+static sem_t g_timer_sem;
+static tcb_t g_timer_task;
+#endif
+
+/*
+ * This function is used to initialize all slots of timer wheel.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+static void timer_wheel_init(void)
+{
+    int level, slot;
+    for (level = 0; level < WHEEL_LEVEL; level++) {
+        for (slot = 0; slot < WHEEL_SIZE; slot++) {
+            g_timer_wheel[level][slot].next = &g_timer_wheel[level][slot];
+            g_timer_wheel[level][slot].prev = &g_timer_wheel[level][slot];
+        }
+        g_timer_bitmap[level] = 0;
+    }
+#if OS_TIMER_TASK
+    //timers started before os starts may expire before timer service task is created
+    semaphore_create(&g_timer_sem, 0);
+#endif
+    g_timer_inited = 1;
+}
+
+/*
+ * This function is used to add timer into the wheel slot of its expire tick.
+ * Input:
+ * timer_handler: handler of timer
+ * Output:
+ * none
+ */
+static void timer_wheel_add(p_soft_timer_t timer_handler)
+{
+    uint32_t expire = timer_handler->expire_tick;
+    uint32_t delta = expire - g_timer_tick;
+    uint32_t level = 0;
+
+    if ((int32_t)delta < 0) {
+        //already expired, check it at the next tick
+        expire = g_timer_tick;
+        delta = 0;
+    } else if (delta >= WHEEL_SPAN) {
+        //beyond the wheel, park it at the farthest slot and it is cascaded again later
+        expire = g_timer_tick + WHEEL_SPAN - 1;
+        delta = WHEEL_SPAN - 1;
+    }
+
+    while (delta >= (1U << LEVEL_SHIFT(level + 1))) {
+        level++;
+    }
+
+    uint32_t slot = (expire >> LEVEL_SHIFT(level)) & WHEEL_MASK;
+    list_add_before(&timer_handler->list, &g_timer_wheel[level][slot]);
+    g_timer_bitmap[level] |= SLOT_BIT(slot);
+    timer_handler->level = level;
+    timer_handler->slot = slot;
+}
+
+/*
+ * This function is used to remove timer from its wheel slot.
+ * Input:
+ * timer_handler: handler of timer
+ * Output:
+ * none
+ */
+static void timer_wheel_del(p_soft_timer_t timer_handler)
+{
+    list_del(&timer_handler->list);
+    if (list_empty(&g_timer_wheel[timer_handler->level][timer_handler->slot])) {
+        g_timer_bitmap[timer_handler->level] &= ~SLOT_BIT(timer_handler->slot);
+    }
+}
+
+/*
+ * This function is used to coalesce timeouts, the tick with the most trailing zero bits in [@due, @due + @slack]
+ * is chosen, so that timers whose slack windows overlap are likely to pick the same tick.
+ * Input:
+ * due:   tick the timer is due
+ * slack: ticks the timeout may be deferred
+ * Output:
+ * tick to be timeout
+ */
+static uint32_t timer_align(uint32_t due,
+                            uint32_t slack)
+{
+    uint32_t late = g_timer_tick - due;
+    if ((int32_t)late > 0) {
+        //due tick has passed, for example a repeat timer with slack longer than its period, use the rest of window
+        if (late > slack) {
+            return due;
+        }
+        due = g_timer_tick;
+        slack -= late;
+    }
+
+    uint32_t last = due + slack;
+    if (slack == 0) {
+        return due;
+    }
+    if (last < due) {
+        //window wraps around, 0 is in it
+        return 0;
+    }
+
+    //clear all bits below the highest bit that differs between @due and @last
+    uint32_t mask = (0x80000000U >> __builtin_clz(due ^ last)) - 1;
+    return last & ~mask;
+}
+
+/*
+ * This function is used to move timers of upper levels down when lower levels wrap around.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+static void timer_wheel_cascade(void)
+{
+    uint32_t level;
+
+    for (level = 1; level < WHEEL_LEVEL; level++) {
+        if (g_timer_tick & ((1U << LEVEL_SHIFT(level)) - 1)) {
+            //lower level does not wrap around at this tick
+            break;
+        }
+
+        uint32_t slot = (g_timer_tick >> LEVEL_SHIFT(level)) & WHEEL_MASK;
+        struct list_head *head = &g_timer_wheel[level][slot];
+        while (g_timer_bitmap[level] & SLOT_BIT(slot)) {
+            p_soft_timer_t timer = list_entry(head->next, typeof(soft_timer_t), list);
+            timer_wheel_del(timer);
+            timer_wheel_add(timer);
+        }
+    }
+}
+
 
 /*
  * This function is used to create a software timer.
@@ -18,6 +182,7 @@ list_head_init(g_timer_list_head);
  * timeout_func:  function to call when time is up
  * parameter:     input of timeout function
  * init_tick:     timeout of timer in tick
+ * slack:         ticks the timeout may be deferred, so that timers close to each other fire in the same tick
  * type:          type of timer
  * Output:
  * create result: 0 - ok
@@ -28,6 +193,7 @@ err_t soft_timer_create(p_soft_timer_t timer_handler,
                         void (*timeout_func) (void *parameter),
                         void *parameter,
                         uint32_t init_tick,
+                        uint32_t slack,
                         timer_type_t type)
 {
     //initialize timer handler
@@ -35,14 +201,18 @@ err_t soft_timer_create(p_soft_timer_t timer_handler,
     timer_handler->timeout_func = (void *)timeout_func;
     timer_handler->parameter = (void *)parameter;
     timer_handler->init_tick = init_tick;
-    timer_handler->timeout_tick = init_tick;
+    timer_handler->slack = slack;
+    timer_handler->due_tick = 0;
+    timer_handler->expire_tick = 0;
     timer_handler->type = type;
+    timer_handler->list.next = NULL;
+    timer_handler->expired.next = NULL;
 
     return ERR_OK;
 }
 
 /*
- * This function is used to start the given software timer.
+ * This function is used to start the given software timer, a running timer is restarted.
  * Input:
  * timer_handler: handler of timer
  * Output:
@@ -50,33 +220,20 @@ err_t soft_timer_create(p_soft_timer_t timer_handler,
  */
 void soft_timer_start(p_soft_timer_t timer_handler)
 {
-    if (list_empty(&g_timer_list_head)) {
-        //the first entry, add to list directly
-        list_add_before(&timer_handler->list, &g_timer_list_head);
-    } else {
-        p_soft_timer_t itr, itr_next;
-        list_for_each_entry_safe(itr, itr_next, &g_timer_list_head, list) {
-            if (timer_handler->timeout_tick <= itr->timeout_tick) {   //new timer will be the first
-                itr->timeout_tick -= timer_handler->timeout_tick;
-                list_add_after(&timer_handler->list, &g_timer_list_head);
-                break;
-            } else {
-                timer_handler->timeout_tick -= itr->timeout_tick;
-                if (&itr_next->list != &g_timer_list_head) {  //@itr is not the last entry
-                    if (timer_handler->timeout_tick < itr_next->timeout_tick) {
-                        itr_next->timeout_tick -= timer_handler->timeout_tick;
-                        list_add_between(&timer_handler->list, &itr->list, &itr_next->list);
-                        break;
-                    } else {
-                        continue;
-                    }
-                } else {   //@itr is the last entry
-                    list_add_before(&timer_handler->list, &g_timer_list_head);
-                    break;
-                }
-            }
-        }
+    uint32_t level = interrupt_disable();
+    if (!g_timer_inited) {
+        timer_wheel_init();
+    }
+
+    if (timer_handler->list.next != NULL) {
+        //restart a running timer
+        timer_wheel_del(timer_handler);
     }
+
+    timer_handler->due_tick = g_timer_tick + timer_handler->init_tick;
+    timer_handler->expire_tick = timer_align(timer_handler->due_tick, timer_handler->slack);
+    timer_wheel_add(timer_handler);
+    interrupt_enable(level);
 }
 
 /*
@@ -88,10 +245,79 @@ void soft_timer_start(p_soft_timer_t timer_handler)
  */
 void soft_timer_stop(p_soft_timer_t timer_handler)
 {
-    //remove entry from list
-    list_del(&timer_handler->list);
+    uint32_t level = interrupt_disable();
+    //timer may be stopped already or have expired
+    if (timer_handler->list.next != NULL) {
+        timer_wheel_del(timer_handler);
+    }
+#if OS_TIMER_TASK
+    //timeout function is not called if the timer is stopped before timer service task runs it
+    if (timer_handler->expired.next != NULL) {
+        list_del(&timer_handler->expired);
+    }
+#endif
+    interrupt_enable(level);
+}
+
+#if OS_TIMER_TASK
+/*
+ * This function is the body of timer service task, it calls timeout functions of expired timers.
+ * Input:
+ * parameter: not used
+ * Output:
+ * none
+ */
+static void timer_task_entry(void *parameter)
+{
+    while (1) {
+        semaphore_take(&g_timer_sem, WAIT_FOREVER);
+
+        uint32_t level = interrupt_disable();
+        while (!list_empty(&g_timer_expired_list)) {
+            p_soft_timer_t timer = list_entry(g_timer_expired_list.next, typeof(soft_timer_t), expired);
+            list_del(&timer->expired);
+
+            //time is up, timeout function is allowed to block here
+            interrupt_enable(level);
+            ((void (*) (void *))timer->timeout_func)(timer->parameter);
+            level = interrupt_disable();
+        }
+        interrupt_enable(level);
+    }
 }
 
+/*
+ * This function is used to create timer service task, it is called when os starts.
+ * Input:
+ * none
+ * Output:
+ * result: 0 - ok
+ *         1 - fail
+ */
+err_t soft_timer_task_create(void)
+{
+    void *stack = (void *)os_malloc(OS_TIMER_TASK_STACK);
+    if (stack == NULL) {
+        return ERR_FAIL;
+    }
+
+    uint32_t level = interrupt_disable();
+    if (!g_timer_inited) {
+        timer_wheel_init();
+    }
+    interrupt_enable(level);
+
+    return task_create_static(&g_timer_task,
+                              "timer_task",
+                              timer_task_entry,
+                              NULL,
+                              OS_TIMER_TASK_PRIO,
+                              stack,
+                              OS_TIMER_TASK_STACK,
+                              0xffffffff);
+}
+#endif
+
 /*
  * This function is used to check timer timeout.
  * Input:
@@ -101,20 +327,118 @@ void soft_timer_stop(p_soft_timer_t timer_handler)
  */
 void soft_timer_check(void)
 {
-    if (!list_empty(&g_timer_list_head)) {
-        p_soft_timer_t timer = NULL;
-        timer = list_entry((&g_timer_list_head)->next, typeof(soft_timer_t), list);
-        if (timer->timeout_tick == 0) {
-            //time is up
-            ((void (*) (void *))timer->timeout_func)(timer->parameter);
-            soft_timer_stop(timer);
+    uint32_t level = interrupt_disable();
+    uint32_t slot = g_timer_tick & WHEEL_MASK;
+    struct list_head *head = &g_timer_wheel[0][slot];
+    struct list_head expired;
+#if OS_TIMER_TASK
+    uint8_t wake = 0;
+#endif
+
+    timer_wheel_cascade();
+    g_timer_tick++;
 
-            if (timer->type == TYPE_REPEAT) {
-                //insert timer to timer list again
-                timer->timeout_tick = timer->init_tick;
-                soft_timer_start(timer);
+    if (!(g_timer_bitmap[0] & SLOT_BIT(slot))) {
+        interrupt_enable(level);
+        return;
+    }
+
+    //every timer in the slot is expired, detach them all at once, timers started by callbacks never join this batch
+    expired.next = head->next;
+    expired.prev = head->prev;
+    expired.next->prev = &expired;
+    expired.prev->next = &expired;
+    head->next = head;
+    head->prev = head;
+    g_timer_bitmap[0] &= ~SLOT_BIT(slot);
+
+    //callbacks may stop other timers of the batch, so always take the first one left
+    while (!list_empty(&expired)) {
+        p_soft_timer_t timer = list_entry(expired.next, typeof(soft_timer_t), list);
+        timer_wheel_del(timer);
+
+        if (timer->type & TYPE_REPEAT) {
+            //insert timer to timer wheel again, based on its own due tick so that it does not drift
+            timer->due_tick += timer->init_tick;
+            timer->expire_tick = timer_align(timer->due_tick, timer->slack);
+            timer_wheel_add(timer);
+        }
+
+#if OS_TIMER_TASK
+        if (!(timer->type & TYPE_ISR)) {
+            //hand over to timer service task, a timer still waiting there is not queued twice
+            if (timer->expired.next == NULL) {
+                list_add_before(&timer->expired, &g_timer_expired_list);
+                wake = 1;
             }
+            continue;
+        }
+#endif
+
+        //time is up
+        interrupt_enable(level);
+        ((void (*) (void *))timer->timeout_func)(timer->parameter);
+        level = interrupt_disable();
+    }
+    interrupt_enable(level);
+
+#if OS_TIMER_TASK
+    if (wake) {
+        //released for every batch, an extra release only makes the service task find an empty list
+        semaphore_release_from_isr(&g_timer_sem);
+    }
+#endif
+}
+
+/*
+ * This function is used to get the ticks until the first timer is timeout.
+ * Input:
+ * none
+ * Output:
+ * ticks to the next timeout, 0xFFFFFFFF if no timer is started
+ */
+uint32_t soft_timer_get_next_timeout(void)
+{
+    uint32_t next = 0xFFFFFFFF;
+    uint32_t level;
+
+    for (level = 0; level < WHEEL_LEVEL; level++) {
+        if (g_timer_bitmap[level] == 0) {
+            continue;
+        }
+
+        //the first tick at which slots of this level are handled
+        uint32_t shift = LEVEL_SHIFT(level);
+        uint32_t first = g_timer_tick >> shift;
+        if (g_timer_tick & ((1U << shift) - 1)) {
+            first++;
+        }
+
+        //distance in slots to the first non-empty slot
+        uint32_t index = first & WHEEL_MASK;
+        uint32_t map = (g_timer_bitmap[level] >> index) | (g_timer_bitmap[level] << ((WHEEL_SIZE - index) & WHEEL_MASK));
+        uint32_t ticks = ((first + __builtin_ctz(map)) << shift) - g_timer_tick;
+
+        //for upper levels this is the cascading tick, which is no later than any timer in the slot
+        if (ticks < next) {
+            next = ticks;
         }
-        timer->timeout_tick--;
     }
+
+    //timer is checked to be timeout at the (@next + 1)th tick from now
+    return next == 0xFFFFFFFF ? next : next + 1;
+}
+
+/*
+ * This function is used to advance timer list without checking, used by tickless idle.
+ * No timer is allowed to be timeout during the skipped ticks.
+ * Input:
+ * ticks: tick count to advance
+ * Output:
+ * none
+ */
+void soft_timer_step(uint32_t ticks)
+{
+    //no slot is due and no non-empty slot is cascaded within the skipped ticks
+    g_timer_tick += ticks;
 }
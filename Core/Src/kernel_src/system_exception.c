@@ -4,42 +4,104 @@
  * Change Logs:
  * Date           Notes
  * Feb 27, 2021   the first version
+ * Oct 18, 2026   add lazy fpu context switch
+ * Oct 18, 2026   switch context in a single pass without calling c functions
+ * Oct 18, 2026   add cpu usage accounting
+ * Oct 18, 2026   back HAL_GetTick() by os tick
+ * Oct 18, 2026   mask by BASEPRI instead of PRIMASK
  */
 
 #include "kernel_inc/system_exception.h"
 
+#define STR(x)  #x
+#define XSTR(x) STR(x)
+
+/*
+ * Context is switched in a single pass, @sp is the first member of tcb_t,
+ * so that psp is saved to and loaded from the tcb without any offset.
+ */
 __attribute__((naked)) void PendSV_Handler(void)
 {
     //1. save the context of current task
     __asm volatile("MRS R0, PSP");
-    __asm volatile("STMDB R0!, {R4-R11}");
+#if OS_USE_FPU
+    //bit 4 of EXC_RETURN is cleared if task uses fpu, only then S16-S31 are saved
+    __asm volatile("TST LR, #0x10");
+    __asm volatile("IT EQ");
+    __asm volatile("VSTMDBEQ R0!, {S16-S31}");
+#endif
+    //EXC_RETURN is saved with the context, since it tells the frame type of each task
+    __asm volatile("STMDB R0!, {R4-R11, LR}");
 
-    //save lr before call other function
-    __asm volatile("PUSH {LR}");
+    //2. save the current value of psp, g_cur_task->sp = psp
+    __asm volatile("MOVW R1, #:lower16:g_cur_task");
+    __asm volatile("MOVT R1, #:upper16:g_cur_task");
+    __asm volatile("LDR R2, [R1]");
+    __asm volatile("STR R0, [R2]");
 
-    //2. save the current value of psp
-    __asm volatile("BL save_current_psp");
+    //mask interrupts which may call kernel APIs, interrupts above the ceiling are not delayed
+    __asm volatile("MOV R3, #" XSTR(OS_KERNEL_BASEPRI));
+    __asm volatile("MSR BASEPRI, R3");
+    __asm volatile("DSB");
+    __asm volatile("ISB");
+#if OS_CPU_USAGE
+    //charge cycles since last switch to current task, g_cur_task->run_cycles += DWT_CYCCNT - g_switch_cycles
+    __asm volatile("MOVW R3, #0x1004");
+    __asm volatile("MOVT R3, #0xE000");
+    __asm volatile("LDR R3, [R3]");
+    __asm volatile("MOVW R12, #:lower16:g_switch_cycles");
+    __asm volatile("MOVT R12, #:upper16:g_switch_cycles");
+    __asm volatile("LDR R0, [R12]");
+    __asm volatile("STR R3, [R12]");
+    __asm volatile("SUB R0, R3, R0");
+    __asm volatile("LDR R3, [R2, #4]");
+    __asm volatile("ADD R3, R3, R0");
+    __asm volatile("STR R3, [R2, #4]");
+#endif
 
-    //3. retrieve the context of next task
-    __asm volatile("BL get_next_psp");
+    //3. update current task with next task, g_cur_task = g_next_task
+    __asm volatile("MOVW R3, #:lower16:g_next_task");
+    __asm volatile("MOVT R3, #:upper16:g_next_task");
+    __asm volatile("LDR R2, [R3]");
+    __asm volatile("STR R2, [R1]");
+    __asm volatile("MOV R3, #0");
+    __asm volatile("MSR BASEPRI, R3");
 
-    __asm volatile("LDMIA R0!, {R4-R11}");
+    //4. retrieve the context of next task
+    __asm volatile("LDR R0, [R2]");
+    __asm volatile("LDMIA R0!, {R4-R11, LR}");
+#if OS_USE_FPU
+    __asm volatile("TST LR, #0x10");
+    __asm volatile("IT EQ");
+    __asm volatile("VLDMIAEQ R0!, {S16-S31}");
+#endif
 
-    //update psp
-    __asm volatile("MSR PSP,R0");
-
-    //update current task with next task and exit
-    __asm volatile("BL update_cur_with_next");
-    __asm volatile("POP {LR}");
+    //update psp and exit
+    __asm volatile("MSR PSP, R0");
     __asm volatile("BX LR");
 }
 
 void SysTick_Handler(void)
 {
-    //HAL_IncTick();
+    //wake-ups of timers and delayed tasks are scheduled once at os_isr_exit()
+    os_isr_enter();
+
+    //HAL tick is not counted here, HAL_GetTick() reads os tick instead
     soft_timer_check();
 
     update_task_state();
 
-    task_schedule();
+    os_isr_exit();
+}
+
+/*
+ * This function overrides the weak one in HAL, so that HAL timeouts and HAL_Delay() use os tick.
+ * Input:
+ * none
+ * Output:
+ * current os tick count
+ */
+uint32_t HAL_GetTick(void)
+{
+    return os_tick_get();
 }
@@ -6,28 +6,199 @@
  * Feb 24, 2021   the first version
  * Mar  3, 2021   add priority to task
  * Mar 11, 2021   add ipc support to task
+ * Oct 18, 2026   replace priority list with ready bitmap
+ * Oct 18, 2026   add sorted delay list and os tick
+ * Oct 18, 2026   add tickless idle support
+ * Oct 18, 2026   add lazy fpu context switch
+ * Oct 18, 2026   switch context in a single pass without calling c functions
+ * Oct 18, 2026   add cpu usage accounting
+ * Oct 18, 2026   add stack high water mark
+ * Oct 18, 2026   add periodic task delay
+ * Oct 18, 2026   add edf scheduling class
+ * Oct 18, 2026   add execution time budget
+ * Oct 18, 2026   create timer service task
+ * Oct 18, 2026   start high resolution timer
+ * Oct 18, 2026   add 64-bit tick and nanosecond time
+ * Oct 18, 2026   ipc timeout by delay list instead of software timer
+ * Oct 18, 2026   set PendSV and SysTick priority
+ * Oct 18, 2026   add interrupt nesting and deferred reschedule
+ * Oct 18, 2026   add scheduler lock
+ * Oct 18, 2026   add direct to task notification
  */
 
+#include "kernel_inc/hrtimer.h"
+#include "kernel_inc/ipc.h"
+#include "kernel_inc/soft_timer.h"
 #include "kernel_inc/task.h"
+#include "kernel_inc/tickless.h"
 
-static p_tcb_t g_cur_task = NULL;
-static p_tcb_t g_next_task = NULL;
+//current and next task are accessed by PendSV_Handler directly
+p_tcb_t g_cur_task = NULL;
+p_tcb_t g_next_task = NULL;
 static tcb_t g_idle_handle;
 
-list_head_init(g_prio_list_head);
+//set right before the first task runs, tick and schedule do nothing until then
+static volatile uint8_t g_os_started = 0;
 
-p_prio_list_t create_prio_list_entry(p_tcb_t task_handler)
+//ready list of each priority, and bitmap of non-empty ready lists
+static struct list_head g_ready_list[OS_PRIO_MAX];
+static uint32_t g_ready_table[PRIO_GROUP_NUM];
+static uint32_t g_ready_group = 0;
+static uint8_t g_ready_inited = 0;
+
+#if OS_EDF
+//ready edf tasks in a binary min-heap keyed on absolute deadline
+static p_tcb_t g_edf_heap[OS_EDF_TASK_MAX];
+static uint32_t g_edf_heap_size = 0;
+static uint32_t g_edf_task_num = 0;
+
+//an edf task boosted by mutex priority inheritance leaves the heap and uses the ready list of its new priority
+#define TASK_IN_EDF_HEAP(task) ((task)->sched_class == SCHED_EDF && (task)->prio == OS_EDF_PRIO)
+#define DEADLINE_BEFORE(a, b)  ((int32_t)((a)->abs_deadline - (b)->abs_deadline) < 0)
+#endif
+
+//delayed tasks sorted by wake tick, so that tick handler only checks the head
+list_head_init(g_delay_list_head);
+static volatile uint32_t g_os_tick = 0;
+static volatile uint32_t g_os_tick_high = 0;   //high 32 bits of 64-bit tick count
+
+//used for nanosecond time
+#define SYST_LOAD (*(volatile uint32_t *)0xE000E014)   //SysTick reload value register
+#define SYST_VAL  (*(volatile uint32_t *)0xE000E018)   //SysTick current value register
+#define ICSR      (*(volatile uint32_t *)0xE000ED04)   //interrupt control and state register
+#define SHPR3     (*(volatile uint32_t *)0xE000ED20)   //system handler priority register 3
+extern uint32_t SystemCoreClock;
+static uint32_t g_tick_cycles = 0;         //SysTick counts of one tick
+static uint64_t g_ns_per_tick = 0;
+static uint64_t g_ns_per_cycle_q32 = 0;    //nanoseconds per cpu cycle in 32.32 fixed point
+
+//all created tasks
+list_head_init(g_task_list_head);
+
+//interrupt nesting level and scheduler lock count, reschedule is deferred while either is not 0
+static volatile uint32_t g_isr_nest = 0;
+static volatile uint32_t g_sched_lock = 0;
+static volatile uint8_t g_resched_pending = 0;
+
+#if OS_BUDGET
+//tasks waiting for budget replenishment, sorted by replenish tick
+list_head_init(g_budget_list_head);
+#endif
+
+#if OS_CPU_USAGE
+#define DEMCR      (*(volatile uint32_t *)0xE000EDFC)
+#define DWT_CTRL   (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT (*(volatile uint32_t *)0xE0001004)
+
+//cycle count at last context switch, accessed by PendSV_Handler
+uint32_t g_switch_cycles = 0;
+static uint32_t g_window_start_cycles = 0;
+static uint32_t g_window_cycles = 0;
+static uint32_t g_window_start_tick = 0;
+#endif
+
+/*
+ * This function is used to initialize ready list of each priority.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+static void ready_list_init(void)
+{
+    int i;
+    for (i = 0; i < OS_PRIO_MAX; i++) {
+        g_ready_list[i].next = &g_ready_list[i];
+        g_ready_list[i].prev = &g_ready_list[i];
+    }
+    for (i = 0; i < PRIO_GROUP_NUM; i++) {
+        g_ready_table[i] = 0;
+    }
+    g_ready_group = 0;
+    g_ready_inited = 1;
+}
+
+#if OS_EDF
+/*
+ * This function is used to put the task at @index of edf heap.
+ * Input:
+ * task_handler: handler of task
+ * index:        index in edf heap
+ * Output:
+ * none
+ */
+static void edf_heap_set(p_tcb_t task_handler,
+                         uint32_t index)
+{
+    g_edf_heap[index] = task_handler;
+    task_handler->heap_index = index;
+}
+
+/*
+ * This function is used to move the task at @index up or down until heap order is restored.
+ * Input:
+ * index: index in edf heap
+ * Output:
+ * none
+ */
+static void edf_heap_fix(uint32_t index)
 {
-    p_prio_list_t prio_list = (p_prio_list_t)os_malloc(sizeof(prio_list_t));
+    p_tcb_t task = g_edf_heap[index];
+
+    //move up while deadline is earlier than parent
+    while (index > 0 && DEADLINE_BEFORE(task, g_edf_heap[(index - 1) / 2])) {
+        edf_heap_set(g_edf_heap[(index - 1) / 2], index);
+        index = (index - 1) / 2;
+    }
+
+    //move down while a child has earlier deadline
+    while (2 * index + 1 < g_edf_heap_size) {
+        uint32_t child = 2 * index + 1;
+        if (child + 1 < g_edf_heap_size && DEADLINE_BEFORE(g_edf_heap[child + 1], g_edf_heap[child])) {
+            child++;
+        }
+        if (!DEADLINE_BEFORE(g_edf_heap[child], task)) {
+            break;
+        }
+        edf_heap_set(g_edf_heap[child], index);
+        index = child;
+    }
+
+    edf_heap_set(task, index);
+}
 
-    prio_list->prio = task_handler->prio;
+/*
+ * This function is used to add the given task into edf heap.
+ * Input:
+ * task_handler: handler of task
+ * Output:
+ * none
+ */
+static void edf_heap_push(p_tcb_t task_handler)
+{
+    edf_heap_set(task_handler, g_edf_heap_size++);
+    edf_heap_fix(task_handler->heap_index);
+}
 
-    //initialize task list head
-    prio_list->task_list_head.next = &prio_list->task_list_head;
-    prio_list->task_list_head.prev = &prio_list->task_list_head;
+/*
+ * This function is used to remove the given task from edf heap.
+ * Input:
+ * task_handler: handler of task
+ * Output:
+ * none
+ */
+static void edf_heap_remove(p_tcb_t task_handler)
+{
+    uint32_t index = task_handler->heap_index;
 
-    return prio_list;
+    //fill the hole with the last entry
+    g_edf_heap_size--;
+    if (index != g_edf_heap_size) {
+        edf_heap_set(g_edf_heap[g_edf_heap_size], index);
+        edf_heap_fix(index);
+    }
 }
+#endif
 
 /*
  * This function is used to insert the given task into task schedule list.
@@ -38,53 +209,96 @@ p_prio_list_t create_prio_list_entry(p_tcb_t task_handler)
  */
 void insert_task_to_list(p_tcb_t task_handler)
 {
-    if (list_empty(&g_prio_list_head)) {
-        p_prio_list_t prio_list = NULL;
-        prio_list = create_prio_list_entry(task_handler);
+    uint8_t prio = task_handler->prio;
 
-        list_add_before(&prio_list->list, &g_prio_list_head);               //deal priority list
-        list_add_before(&task_handler->list, &prio_list->task_list_head);   //deal task list of this priority
+    //add to the end of ready list and mark the priority as ready
+#if OS_EDF
+    if (TASK_IN_EDF_HEAP(task_handler)) {
+        edf_heap_push(task_handler);
+    } else
+#endif
+    list_add_before(&task_handler->list, &g_ready_list[prio]);
+    g_ready_table[prio >> 5] |= PRIO_BIT(prio);
+    g_ready_group |= PRIO_BIT(prio >> 5);
+}
+
+/*
+ * This function is used to remove the given task from task schedule list.
+ * Input:
+ * task_handler: handler of task
+ * Output:
+ * none
+ */
+void remove_task_from_list(p_tcb_t task_handler)
+{
+    uint8_t prio = task_handler->prio;
 
-    } else {     //list not empty
-        p_prio_list_t itr, itr_next;
+#if OS_EDF
+    if (TASK_IN_EDF_HEAP(task_handler)) {
+        edf_heap_remove(task_handler);
+    } else
+#endif
+    list_del(&task_handler->list);
 
-        list_for_each_entry_safe(itr, itr_next, &g_prio_list_head, list) {
+    //clear the ready bit if no task is left in this priority
+#if OS_EDF
+    if (prio == OS_EDF_PRIO && g_edf_heap_size != 0) {
+        return;
+    }
+#endif
+    if (list_empty(&g_ready_list[prio])) {
+        g_ready_table[prio >> 5] &= ~PRIO_BIT(prio);
+        if (g_ready_table[prio >> 5] == 0) {
+            g_ready_group &= ~PRIO_BIT(prio >> 5);
+        }
+    }
+}
 
-            if (task_handler->prio == itr->prio) {
-                list_add_before(&task_handler->list, &itr->task_list_head);   //deal task list of this priority
-                break;
-            } else if (task_handler->prio < itr->prio) {
-                p_prio_list_t prio_list = NULL;
-                prio_list = create_prio_list_entry(task_handler);
+/*
+ * This function is used to add the given task into delay list.
+ * Input:
+ * task_handler: handler of task
+ * wake_tick:    absolute os tick to wake up the task
+ * Output:
+ * none
+ */
+static void delay_list_add(p_tcb_t task_handler,
+                           uint32_t wake_tick)
+{
+    task_handler->wake_tick = wake_tick;
 
-                list_add_after(&prio_list->list, &g_prio_list_head);                //deal priority list
-                list_add_before(&task_handler->list, &prio_list->task_list_head);   //deal task list of this priority
-                break;
-            } else {  //current priority value is greater than @itr->prio
-
-                if (&itr_next->list != &g_prio_list_head) {   //@itr is not the last entry of the list
-
-                    if (task_handler->prio < itr_next->prio) {
-                        p_prio_list_t prio_list = NULL;
-                        prio_list = create_prio_list_entry(task_handler);
-
-                        list_add_between(&prio_list->list, &itr->list, &itr_next->list);    //deal priority list
-                        list_add_before(&task_handler->list, &prio_list->task_list_head);   //deal task list of this priority
-                        break;
-                    } else {
-                        continue;
-                    }
-                 } else {   //@itr is the last entry of list
-                     p_prio_list_t prio_list = NULL;
-                     prio_list = create_prio_list_entry(task_handler);
-
-                     list_add_before(&prio_list->list, &g_prio_list_head);             //deal priority list
-                     list_add_before(&task_handler->list, &prio_list->task_list_head); //deal task list of this priority
-                     break;
-                 }
-            }
+    //insert after all tasks waking at or before @wake_tick, tick may wrap around
+    p_tcb_t itr = NULL;
+    list_for_each_entry(itr, &g_delay_list_head, delay_list) {
+        if ((int32_t)(itr->wake_tick - wake_tick) > 0) {
+            break;
         }
     }
+    list_add_before(&task_handler->delay_list, &itr->delay_list);
+}
+
+/*
+ * This function is used to change priority of the given task.
+ * Input:
+ * task_handler: handler of task
+ * prio:         new priority of task
+ * Output:
+ * none
+ */
+void task_change_prio(p_tcb_t task_handler,
+                      uint8_t prio)
+{
+    uint32_t level = interrupt_disable();
+    if (task_handler->state != TASK_PENDING) {
+        //task is in ready list, move it to the ready list of new priority
+        remove_task_from_list(task_handler);
+        task_handler->prio = prio;
+        insert_task_to_list(task_handler);
+    } else {
+        //new priority takes effect when the task is ready again
+        task_handler->prio = prio;
+    }
+    interrupt_enable(level);
 }
 
 /*
@@ -110,6 +324,10 @@ err_t task_create_static(p_tcb_t task_handler,
                          uint32_t stack_size,
                          uint32_t init_tick)
 {
+    if (prio >= OS_PRIO_MAX) {
+        return ERR_FAIL;
+    }
+
     //initialize tcb
     strncpy(task_handler->name, name, NAME_MAX_LEN);
     task_handler->entry = (void *)entry;
@@ -122,10 +340,33 @@ err_t task_create_static(p_tcb_t task_handler,
     task_handler->state = TASK_READY;
     task_handler->event = 0;
     task_handler->error = ERR_OK;
+    task_handler->delay_list.next = NULL;
+    task_handler->msg_buf = NULL;
+    task_handler->msg_size = 0;
+    task_handler->notify_value = 0;
+    task_handler->notify_state = NOTIFY_NONE;
+    memset(&task_handler->period_stat, 0, sizeof(period_stat_t));
+#if OS_EDF
+    task_handler->sched_class = SCHED_FIXED;
+#endif
+#if OS_BUDGET
+    task_handler->budget = 0;
+#endif
 
-    uint32_t level = interrupt_disable();
-    insert_task_to_list(task_handler);
-    interrupt_enable(level);
+#if OS_CPU_USAGE
+    task_handler->run_cycles = 0;
+    task_handler->window_cycles = 0;
+    task_handler->last_run_cycles = 0;
+#endif
+
+#if OS_STACK_CHECK
+    //paint the whole stack, initial frame is written on top of it below
+    uint32_t *stack_word = (uint32_t *)stack_addr;
+    uint32_t word_num = stack_size / sizeof(uint32_t);
+    while (word_num--) {
+        *stack_word++ = STACK_PAINT_PATTERN;
+    }
+#endif
 
     task_handler->sp = (uint32_t *)((uint32_t)stack_addr + stack_size);
 
@@ -142,19 +383,32 @@ err_t task_create_static(p_tcb_t task_handler,
     (task_handler->sp)--;
     *(task_handler->sp) = 0xFFFFFFFD;//return to thread mode using psp, so that another task can be schedule
 
-    //r12, r3 ~ r0, r11 ~ r4
+    //r12, r3 ~ r0, EXC_RETURN, r11 ~ r4
+    //task starts with a basic frame, hardware switches to extended frame once it uses fpu
     int i;
-    for (i = 0; i < 13; i++) {
+    for (i = 0; i < 14; i++) {
         (task_handler->sp)--;
         if (i == 4) {
             //put parameter into r0
             *(task_handler->sp) = (uint32_t)parameter;
+        } else if (i == 5) {
+            //EXC_RETURN popped by PendSV_Handler
+            *(task_handler->sp) = TASK_EXC_RETURN;
         } else {
             *(task_handler->sp) = 0;
         }
 
     }
 
+    //task becomes visible to scheduler only after its stack and sp are ready
+    uint32_t level = interrupt_disable();
+    if (!g_ready_inited) {
+        ready_list_init();
+    }
+    insert_task_to_list(task_handler);
+    list_add_before(&task_handler->task_list, &g_task_list_head);
+    interrupt_enable(level);
+
     return ERR_OK;
 }
 
@@ -195,7 +449,11 @@ err_t task_create(p_tcb_t task_handler,
 
 void idle_entry(void *para)
 {
-    while (1);
+    while (1) {
+#if OS_TICKLESS_IDLE
+        tickless_idle();
+#endif
+    }
 }
 
 /*
@@ -213,229 +471,1055 @@ err_t idle_task_create(void)
                               "idle_task",
                               idle_entry,
                               NULL,
-                              255,
+                              IDLE_PRIO,
                               idle_stack,
                               IDLE_STACK_SIZE,
                               1);
 }
 
 /*
- * This function is used to get psp of next task.
+ * This function is used to get psp of current task.
  * Input:
  * none
  * Output:
  * next psp
  */
-uint32_t *get_next_psp(void)
+uint32_t *get_current_psp(void)
 {
-    return g_next_task->sp;
+    return g_cur_task->sp;
 }
 
 /*
- * This function is used to get psp of current task.
+ * This function is used to get the next task to schedule.
  * Input:
  * none
  * Output:
- * next psp
+ * none
  */
-uint32_t *get_current_psp(void)
+void get_next_task(void)
 {
-    return g_cur_task->sp;
+    //the highest ready priority is found by two CLZs, whatever the number of tasks
+    uint32_t group = __builtin_clz(g_ready_group);
+    uint32_t prio = (group << 5) + __builtin_clz(g_ready_table[group]);
+    p_tcb_t next;
+
+#if OS_EDF
+    //in edf band, tasks boosted by priority inheritance go first, then the earliest deadline
+    if (prio == OS_EDF_PRIO && list_empty(&g_ready_list[prio])) {
+        next = g_edf_heap[0];
+    } else
+#endif
+    next = list_entry(g_ready_list[prio].next, typeof(tcb_t), list);
+
+    if (next != g_cur_task && g_cur_task->state == TASK_RUNNING) {   //current task is preempted
+        g_cur_task->state = TASK_READY;
+    }
+    next->state = TASK_RUNNING;
+    g_next_task = next;
 }
 
 /*
- * This function is used to save psp of current task.
+ * This function is used to schedule task.
  * Input:
- * sp: current psp
+ * none
  * Output:
  * none
  */
-void save_current_psp(uint32_t *sp)
+void task_schedule(void)
 {
-    g_cur_task->sp = sp;
+    //scheduler is not started yet, g_cur_task is set before psp is ready so it cannot tell
+    if (!g_os_started) {
+        return;
+    }
+
+    uint32_t level = interrupt_disable();
+    if (g_isr_nest != 0 || g_sched_lock != 0) {
+        //in interrupt handler or scheduler locked, schedule once at the outermost exit or unlock
+        g_resched_pending = 1;
+        interrupt_enable(level);
+        return;
+    }
+    get_next_task();
+    interrupt_enable(level);
+
+    if (g_next_task != g_cur_task) {
+        //pend the pendSV exception
+        uint32_t *pICSR = (uint32_t *)0xE000ED04; //address of ICSR
+        *pICSR |= (1 << 28); //set the 28th bit, which is PENDSVSET
+    }
+
 }
 
 /*
- * This function is used to update current task with next task after context switching.
+ * This function is used to start timeout of a task blocked on ipc, the task is put into delay list
+ * while it stays in pending list. It must be called with interrupt disabled.
  * Input:
- * none
+ * task_handler: handler of task
+ * tick:         timeout in tick
  * Output:
  * none
  */
-void update_cur_with_next(void)
+void task_timeout_start(p_tcb_t task_handler,
+                        uint32_t tick)
 {
-    g_cur_task = g_next_task;
+    delay_list_add(task_handler, g_os_tick + tick);
 }
 
 /*
- * This function is used to get the next task to schedule.
+ * This function is used to stop timeout of a task blocked on ipc. It must be called with interrupt disabled.
  * Input:
- * none
+ * task_handler: handler of task
  * Output:
  * none
  */
-void get_next_task(void)
+void task_timeout_stop(p_tcb_t task_handler)
 {
-    //for now no priority is implemented
-    p_prio_list_t prio_itr = NULL;
-
-    list_for_each_entry(prio_itr, &g_prio_list_head, list) {
-        //find the first non-pending task to schedule
-        p_tcb_t itr = NULL;
-        list_for_each_entry(itr, &prio_itr->task_list_head, list) {
-            if (itr->state != TASK_PENDING) {
-                if (itr != g_cur_task) {
-                    itr->state = TASK_RUNNING;
-                    g_next_task = itr;
-                    if (g_cur_task->state == TASK_RUNNING) {   //current task is preempted
-                        g_cur_task->state = TASK_READY;
-                    }
-                } else {
-                    g_next_task = g_cur_task;
-                }
-
-                return;
-            }
-        }
-
+    if (task_handler->delay_list.next != NULL) {
+        list_del(&task_handler->delay_list);
     }
 }
 
 /*
- * This function is used to schedule task.
+ * This function is used to mark entry of an interrupt handler which calls kernel APIs.
+ * Reschedule requested inside the handler is deferred until the outermost os_isr_exit().
  * Input:
  * none
  * Output:
  * none
  */
-void task_schedule(void)
+void os_isr_enter(void)
 {
     uint32_t level = interrupt_disable();
-    get_next_task();
+    g_isr_nest++;
     interrupt_enable(level);
+}
 
-    if (g_next_task != g_cur_task) {
-        //pend the pendSV exception
-        uint32_t *pICSR = (uint32_t *)0xE000ED04; //address of ICSR
-        *pICSR |= (1 << 28); //set the 28th bit, which is PENDSVSET
+/*
+ * This function is used to mark exit of an interrupt handler, PendSV is requested once if any task is woken up.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void os_isr_exit(void)
+{
+    uint8_t resched = 0;
+
+    uint32_t level = interrupt_disable();
+    g_isr_nest--;
+    if (g_isr_nest == 0 && g_resched_pending) {
+        g_resched_pending = 0;
+        resched = 1;
     }
+    interrupt_enable(level);
 
+    if (resched) {
+        task_schedule();
+    }
 }
 
 /*
- * This function is used to delay a task for given ticks.
+ * This function is used to check whether scheduler is locked, blocking APIs fail if it is.
  * Input:
- * tick: tick count to delay
- * Output:
  * none
+ * Output:
+ * 1 if scheduler is locked, otherwise 0
  */
-void task_delay(uint32_t tick)
+uint8_t task_sched_locked(void)
 {
-    g_cur_task->delay_tick = tick;
-    g_cur_task->delay_tick_left = tick;
-    g_cur_task->state = TASK_PENDING;
-    task_schedule();
+    return g_sched_lock != 0;
 }
 
 /*
- * This function is used to show task info.
+ * This function is used to lock scheduler, current task is not switched out until the lock is released.
+ * Interrupts stay enabled, reschedule requested meanwhile is deferred to the last task_sched_unlock().
+ * It can be nested, and task must not block while holding it.
  * Input:
- * task_handler: task control block of task
+ * none
  * Output:
  * none
  */
-void show_task_info(p_tcb_t task_handler)
+void task_sched_lock(void)
 {
-    char str[10] = {0};
-    if (task_handler->state == TASK_READY) {
-        strcpy(str, "ready");
-    } else if (task_handler->state == TASK_PENDING) {
-        strcpy(str, "pending");
-    } else if (task_handler->state == TASK_RUNNING) {
-        strcpy(str, "running");
-    } else {
-        strcpy(str, "undefined");
-    }
-    printf("task info:\r\n");
-    printf("task name: %-20s\r\n", task_handler->name);
-    printf("task entry addr: %10p | task parameter addr: %10p\r\n", task_handler->entry, task_handler->parameter);
-    printf("task stack addr: %10p | task stack size: %14lu\r\n", task_handler->stack_addr, task_handler->stack_size);
-    printf("task state: %15s | task psp: %21p\r\n", str, task_handler->sp);
+    //increment is a read-modify-write, keep it away from interrupt handlers
+    uint32_t level = interrupt_disable();
+    g_sched_lock++;
+    interrupt_enable(level);
 }
 
 /*
- * This function is used to update task state
+ * This function is used to unlock scheduler, deferred reschedule is done when lock count returns to 0.
  * Input:
  * none
  * Output:
  * none
  */
-void update_task_state(void)
+void task_sched_unlock(void)
 {
-    p_prio_list_t prio_itr = NULL;
-    list_for_each_entry(prio_itr, &g_prio_list_head, list) {
-        p_tcb_t itr = NULL;
-        p_tcb_t t_itr = NULL;
-
-        list_for_each_entry_safe(itr, t_itr, &prio_itr->task_list_head, list) {
-            if (itr->state == TASK_RUNNING) {
-                itr->init_tick_left--;
-
-                if (itr->init_tick_left == 0) {
-                    //time silce use up, reset time slice, remove to the end of list and ready to be scheduled
-                    itr->init_tick_left = itr->init_tick;
-                    itr->state = TASK_READY;
-                    list_del(&itr->list);
-                    list_add_before(&itr->list, &prio_itr->task_list_head);
-                }
-                continue;
-            }
+    uint8_t resched = 0;
 
-            if (itr->state == TASK_PENDING) {
-                itr->delay_tick_left--;
+    uint32_t level = interrupt_disable();
+    if (g_sched_lock > 0) {
+        g_sched_lock--;
+    }
+    if (g_sched_lock == 0 && g_resched_pending) {
+        g_resched_pending = 0;
+        resched = 1;
+    }
+    interrupt_enable(level);
 
-                if (itr->delay_tick_left == 0) {
-                    //set the task ready to be scheduled, @delay_tick_left will be updated in task_delay().
-                    itr->state = TASK_READY;
-                    list_del(&itr->list);
-                    list_add_before(&itr->list, &prio_itr->task_list_head);
-                }
-                continue;
-            }
-        }
+    if (resched) {
+        task_schedule();
     }
 }
 
-__attribute__((naked)) void switch_msp_to_psp(void)
+/*
+ * This function is used to notify the given task, it never blocks and can be called in interrupt handler.
+ * Input:
+ * task_handler: handler of task to notify
+ * value:        value used by @action
+ * action:       how notification value is updated
+ * Output:
+ * result:       0 - ok
+ *               1 - fail
+ */
+err_t task_notify(p_tcb_t task_handler,
+                  uint32_t value,
+                  notify_action_t action)
 {
-    //initialize psp
-    __asm volatile("PUSH {LR}");
-    __asm volatile("BL get_current_psp");
-    __asm volatile("MSR PSP, R0");
-    __asm volatile("POP {LR}");
+    if (task_handler == NULL) {
+        return ERR_FAIL;
+    }
 
-    //switch from msp to psp
-    __asm volatile("MOV R0, 0X02");
-    __asm volatile("MSR CONTROL, R0"); //write CONTROL register, SPSEL = 1
-    __asm volatile("BX LR");
+    uint8_t wake = 0;
+
+    uint32_t level = interrupt_disable();
+    switch (action) {
+    case NOTIFY_SET_BITS:
+        task_handler->notify_value |= value;
+        break;
+    case NOTIFY_INCREMENT:
+        task_handler->notify_value++;
+        break;
+    case NOTIFY_OVERWRITE:
+        task_handler->notify_value = value;
+        break;
+    default:
+        interrupt_enable(level);
+        return ERR_FAIL;
+    }
+
+    //a waiting task which is woken up by timeout but not run yet is already ready
+    if (task_handler->notify_state == NOTIFY_WAITING && task_handler->state == TASK_PENDING) {
+        //target task is known, no pending list to search
+        task_timeout_stop(task_handler);
+        task_handler->state = TASK_READY;
+        insert_task_to_list(task_handler);
+        wake = 1;
+    }
+    task_handler->notify_state = NOTIFY_PENDING;
+    interrupt_enable(level);
+
+    if (wake) {
+        task_schedule();
+    }
+
+    return ERR_OK;
 }
 
 /*
- * This function is used to start os schedule
+ * This function is used to wait notification of current task.
  * Input:
- * none
+ * clear_on_exit: bits of notification value cleared after it is read, 0xFFFFFFFF to reset it
+ * value:         to store notification value before clearing, can be NULL
+ * time:          time in tick to wait
  * Output:
- * none
+ * result:        0 - ok
+ *                1 - fail, scheduler is locked
+ *                2 - timeout
  */
-void os_start_schedule(void)
+err_t task_notify_wait(uint32_t clear_on_exit,
+                       uint32_t *value,
+                       uint32_t time)
 {
-    //initialize
-    idle_task_create();
+    p_tcb_t self = task_get_self();
+
+    uint32_t level = interrupt_disable();
+    if (self->notify_state != NOTIFY_PENDING) {
+        if (time == WAIT_NONE) {
+            interrupt_enable(level);
+            return ERR_TIMEOUT;
+        }
+
+        //task must not block while holding scheduler lock
+        if (task_sched_locked()) {
+            interrupt_enable(level);
+            return ERR_FAIL;
+        }
+
+        //block without pending list, timeout is handled by delay list
+        self->notify_state = NOTIFY_WAITING;
+        remove_task_from_list(self);
+        self->state = TASK_PENDING;
+        if (time != WAIT_FOREVER) {
+            task_timeout_start(self, time);
+        }
+        interrupt_enable(level);
+
+        task_schedule();
+
+        level = interrupt_disable();
+        if (self->notify_state == NOTIFY_WAITING) {
+            //woken up by timeout
+            self->notify_state = NOTIFY_NONE;
+            interrupt_enable(level);
+            return ERR_TIMEOUT;
+        }
+    }
+
+    if (value != NULL) {
+        *value = self->notify_value;
+    }
+    self->notify_value &= ~clear_on_exit;
+    self->notify_state = NOTIFY_NONE;
+    interrupt_enable(level);
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to delay a task for given ticks, it returns at once if scheduler is locked.
+ * Input:
+ * tick: tick count to delay
+ * Output:
+ * none
+ */
+void task_delay(uint32_t tick)
+{
+    //task must not block while holding scheduler lock
+    if (task_sched_locked()) {
+        return;
+    }
+
+    uint32_t level = interrupt_disable();
+    g_cur_task->delay_tick = tick;
+    g_cur_task->state = TASK_PENDING;
+
+    //move current task from ready list to delay list
+    remove_task_from_list(g_cur_task);
+    delay_list_add(g_cur_task, g_os_tick + tick);
+    interrupt_enable(level);
+
+    task_schedule();
+}
+
+/*
+ * This function is used to delay a task until an absolute tick, for drift-free periodic task.
+ * It returns at once if scheduler is locked.
+ * If the next release has already passed, the task is not delayed and an overrun is counted.
+ * Input:
+ * last_wake: tick of last release, initialized by os_tick_get() and updated on each call
+ * period:    period in tick
+ * Output:
+ * none
+ */
+void task_delay_until(uint32_t *last_wake,
+                      uint32_t period)
+{
+    p_tcb_t cur_task = g_cur_task;
+    period_stat_t *stat = &cur_task->period_stat;
+
+    //task must not block while holding scheduler lock
+    if (task_sched_locked()) {
+        return;
+    }
+
+    uint32_t level = interrupt_disable();
+    uint32_t wake_tick = *last_wake + period;
+    *last_wake = wake_tick;
+    stat->release_num++;
+
+#if OS_EDF
+    uint32_t deadline = 0;
+    if (cur_task->sched_class == SCHED_EDF) {
+        //current job is done, check its deadline and get the deadline of next job
+        if ((int32_t)(g_os_tick - cur_task->abs_deadline) > 0) {
+            cur_task->deadline_miss++;
+        }
+        deadline = wake_tick + cur_task->rel_deadline;
+    }
+#endif
+
+    if ((int32_t)(wake_tick - g_os_tick) <= 0) {
+        //job finished after its next release, start the next job right now to keep the phase
+        stat->overrun_num++;
+#if OS_EDF
+        if (cur_task->sched_class == SCHED_EDF) {
+            //deadline of current task is later now, other edf task may go first
+            remove_task_from_list(cur_task);
+            cur_task->abs_deadline = deadline;
+            insert_task_to_list(cur_task);
+            interrupt_enable(level);
+            task_schedule();
+            return;
+        }
+#endif
+        interrupt_enable(level);
+        return;
+    }
+
+    cur_task->delay_tick = period;
+    cur_task->state = TASK_PENDING;
+    remove_task_from_list(cur_task);
+#if OS_EDF
+    if (cur_task->sched_class == SCHED_EDF) {
+        cur_task->abs_deadline = deadline;
+    }
+#endif
+    delay_list_add(cur_task, wake_tick);
+    interrupt_enable(level);
+
+    task_schedule();
+
+    //released, measure the time from release to running in nanosecond, saturated at 32 bits
+#if OS_CPU_USAGE
+    uint64_t jitter = ((uint64_t)(DWT_CYCCNT - cur_task->wake_cycles) * g_ns_per_cycle_q32) >> 32;
+#else
+    uint64_t jitter = (uint64_t)(g_os_tick - wake_tick) * g_ns_per_tick;
+#endif
+    stat->jitter_last = (jitter > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)jitter;
+    if (stat->jitter_last > stat->jitter_max) {
+        stat->jitter_max = stat->jitter_last;
+    }
+}
+
+#if OS_EDF
+/*
+ * This function is used to move the given task into edf scheduling class.
+ * Its first job is released now, with an absolute deadline of now + @deadline.
+ * Input:
+ * task_handler: task control block of task
+ * period:       period of task in tick
+ * deadline:     relative deadline of each job in tick
+ * Output:
+ * result:       0 - ok
+ *               1 - fail
+ */
+err_t task_set_edf(p_tcb_t task_handler,
+                   uint32_t period,
+                   uint32_t deadline)
+{
+    if (task_handler == NULL || period == 0 || deadline == 0) {
+        return ERR_FAIL;
+    }
+
+    uint32_t level = interrupt_disable();
+    if (task_handler->sched_class == SCHED_EDF || g_edf_task_num >= OS_EDF_TASK_MAX) {
+        interrupt_enable(level);
+        return ERR_FAIL;
+    }
+
+    //move task from ready list of its priority to edf heap
+    uint8_t ready = (task_handler->state != TASK_PENDING);
+    if (ready) {
+        remove_task_from_list(task_handler);
+    }
+
+    task_handler->sched_class = SCHED_EDF;
+    task_handler->prio = OS_EDF_PRIO;
+    task_handler->period = period;
+    task_handler->rel_deadline = deadline;
+    task_handler->release_tick = g_os_tick;
+    task_handler->abs_deadline = g_os_tick + deadline;
+    task_handler->deadline_miss = 0;
+    g_edf_task_num++;
+
+    if (ready) {
+        insert_task_to_list(task_handler);
+    }
+    interrupt_enable(level);
+
+    task_schedule();
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to finish current job of an edf task and wait for release of the next job.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void task_wait_next_period(void)
+{
+    task_delay_until(&g_cur_task->release_tick, g_cur_task->period);
+}
+#endif
+
+/*
+ * This function is used to get current os tick count.
+ * Input:
+ * none
+ * Output:
+ * ticks elapsed since os is started
+ */
+uint32_t os_tick_get(void)
+{
+    return g_os_tick;
+}
+
+/*
+ * This function is used to get current os tick count in 64 bits, which never wraps around in practice.
+ * Input:
+ * none
+ * Output:
+ * ticks elapsed since SysTick is started
+ */
+uint64_t os_tick_get64(void)
+{
+    uint32_t level = interrupt_disable();
+    uint64_t tick = ((uint64_t)g_os_tick_high << 32) | g_os_tick;
+    interrupt_enable(level);
+
+    return tick;
+}
+
+/*
+ * This function is used to get monotonic time in nanosecond, interpolated within current tick by SysTick counter.
+ * While tickless idle suppresses the tick, it is only accurate to the tick. It returns 0 before os starts.
+ * Input:
+ * none
+ * Output:
+ * nanoseconds elapsed since SysTick is started
+ */
+uint64_t os_time_ns(void)
+{
+    uint32_t level = interrupt_disable();
+    uint64_t tick = ((uint64_t)g_os_tick_high << 32) | g_os_tick;
+    uint32_t val = SYST_VAL;
+    if (ICSR & (1 << 26)) {
+        //counter has reloaded but tick interrupt is not handled yet, PENDSTSET is the 26th bit
+        tick++;
+        val = SYST_VAL;
+    }
+    interrupt_enable(level);
+
+    //counter counts down from reload value, a partial reload after tickless idle also ends at the tick boundary
+    int32_t elapsed = (int32_t)(g_tick_cycles - 1 - val);
+    if (elapsed < 0) {
+        elapsed = 0;
+    }
+
+    return tick * g_ns_per_tick + (((uint64_t)elapsed * g_ns_per_cycle_q32) >> 32);
+}
+
+/*
+ * This function is used to advance os tick count without processing, used by tickless idle.
+ * No task is allowed to expire during the skipped ticks.
+ * Input:
+ * ticks: tick count to advance
+ * Output:
+ * none
+ */
+void os_tick_step(uint32_t ticks)
+{
+    uint32_t tick = g_os_tick + ticks;
+    if (tick < g_os_tick) {
+        g_os_tick_high++;
+    }
+    g_os_tick = tick;
+}
+
+/*
+ * This function is used to get the ticks until the first delayed task wakes up.
+ * Input:
+ * none
+ * Output:
+ * ticks to the next wake up, 0xFFFFFFFF if no task is delayed
+ */
+uint32_t task_get_next_wake(void)
+{
+    uint32_t next = 0xFFFFFFFF;
+    int32_t ticks;
+
+    if (!list_empty(&g_delay_list_head)) {
+        p_tcb_t task = list_entry(g_delay_list_head.next, typeof(tcb_t), delay_list);
+        ticks = (int32_t)(task->wake_tick - g_os_tick);
+        next = ticks > 0 ? (uint32_t)ticks : 0;
+    }
+
+#if OS_BUDGET
+    //budget replenishment may also make a task ready
+    if (!list_empty(&g_budget_list_head)) {
+        p_tcb_t task = list_entry(g_budget_list_head.next, typeof(tcb_t), budget_list);
+        ticks = (int32_t)(task->replenish_tick - g_os_tick);
+        if (ticks <= 0) {
+            next = 0;
+        } else if ((uint32_t)ticks < next) {
+            next = (uint32_t)ticks;
+        }
+    }
+#endif
+
+    return next;
+}
+
+/*
+ * This function is used to check whether idle task is the only ready task.
+ * Input:
+ * none
+ * Output:
+ * 1 - only idle task is ready
+ * 0 - other task is ready
+ */
+uint8_t task_is_idle_only(void)
+{
+    uint32_t group = __builtin_clz(g_ready_group);
+    uint32_t prio = (group << 5) + __builtin_clz(g_ready_table[group]);
+
+    return prio == IDLE_PRIO && g_ready_list[IDLE_PRIO].next == g_ready_list[IDLE_PRIO].prev;
+}
+
+/*
+ * This function is used to show task info.
+ * Input:
+ * task_handler: task control block of task
+ * Output:
+ * none
+ */
+void show_task_info(p_tcb_t task_handler)
+{
+    char str[10] = {0};
+    if (task_handler->state == TASK_READY) {
+        strcpy(str, "ready");
+    } else if (task_handler->state == TASK_PENDING) {
+        strcpy(str, "pending");
+    } else if (task_handler->state == TASK_RUNNING) {
+        strcpy(str, "running");
+    } else {
+        strcpy(str, "undefined");
+    }
+    printf("task info:\r\n");
+    printf("task name: %-20s\r\n", task_handler->name);
+    printf("task entry addr: %10p | task parameter addr: %10p\r\n", task_handler->entry, task_handler->parameter);
+    printf("task stack addr: %10p | task stack size: %14lu\r\n", task_handler->stack_addr, task_handler->stack_size);
+    printf("task state: %15s | task psp: %21p\r\n", str, task_handler->sp);
+    if (task_handler->period_stat.release_num != 0) {
+        period_stat_t *stat = &task_handler->period_stat;
+        printf("task release: %13lu | task overrun: %17lu\r\n", stat->release_num, stat->overrun_num);
+        printf("task jitter(ns): %10lu | task max jitter(ns): %10lu\r\n", stat->jitter_last, stat->jitter_max);
+    }
+#if OS_EDF
+    if (task_handler->sched_class == SCHED_EDF) {
+        printf("task deadline: %12lu | task deadline miss: %11lu\r\n", task_handler->abs_deadline, task_handler->deadline_miss);
+    }
+#endif
+}
+
+#if OS_STACK_CHECK
+/*
+ * This function is used to get the minimum free stack of the given task since it is created.
+ * Input:
+ * task_handler: task control block of task
+ * Output:
+ * free stack in byte which has never been used
+ */
+uint32_t task_get_stack_free(p_tcb_t task_handler)
+{
+    //stack grows down, so the painted words left at the bottom have never been used
+    uint32_t *stack_word = (uint32_t *)task_handler->stack_addr;
+    uint32_t *stack_end = (uint32_t *)((uint32_t)task_handler->stack_addr + task_handler->stack_size);
+
+    while (stack_word < stack_end && *stack_word == STACK_PAINT_PATTERN) {
+        stack_word++;
+    }
+
+    return (uint32_t)stack_word - (uint32_t)task_handler->stack_addr;
+}
+
+/*
+ * This function is used to show used and allocated stack of all tasks.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void show_stack_usage(void)
+{
+    p_tcb_t itr = NULL;
+    uint32_t total_size = 0;
+    uint32_t total_free = 0;
+
+    printf("stack usage:\r\n");
+    list_for_each_entry(itr, &g_task_list_head, task_list) {
+        uint32_t free = task_get_stack_free(itr);
+        printf("task name: %-20s | used: %6lu | size: %6lu\r\n", itr->name, itr->stack_size - free, itr->stack_size);
+        total_size += itr->stack_size;
+        total_free += free;
+    }
+    printf("total used: %6lu | total size: %6lu\r\n", total_size - total_free, total_size);
+}
+#endif
+
+#if OS_CPU_USAGE
+/*
+ * This function is used to close current cpu usage window, called in tick interrupt.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+static void cpu_usage_update(void)
+{
+    uint32_t now = DWT_CYCCNT;
+
+    //charge running task up to now, then take snapshot of all tasks
+    g_cur_task->run_cycles += now - g_switch_cycles;
+    g_switch_cycles = now;
+
+    g_window_cycles = now - g_window_start_cycles;
+    g_window_start_cycles = now;
+    g_window_start_tick = g_os_tick;
+
+    p_tcb_t itr = NULL;
+    list_for_each_entry(itr, &g_task_list_head, task_list) {
+        itr->window_cycles = itr->run_cycles - itr->last_run_cycles;
+        itr->last_run_cycles = itr->run_cycles;
+    }
+}
+
+/*
+ * This function is used to get cpu usage of the given task over the last window.
+ * Input:
+ * task_handler: task control block of task
+ * Output:
+ * cpu usage in permille
+ */
+uint32_t task_get_cpu_usage(p_tcb_t task_handler)
+{
+    if (g_window_cycles == 0) {
+        return 0;
+    }
+
+    return (uint32_t)((uint64_t)task_handler->window_cycles * 1000 / g_window_cycles);
+}
+
+/*
+ * This function is used to get total cpu load over the last window, time spent in idle task is excluded.
+ * Input:
+ * none
+ * Output:
+ * cpu load in permille
+ */
+uint32_t os_get_cpu_load(void)
+{
+    if (g_window_cycles == 0) {
+        return 0;
+    }
+
+    return 1000 - task_get_cpu_usage(&g_idle_handle);
+}
+
+/*
+ * This function is used to show cpu usage of all tasks.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void show_cpu_usage(void)
+{
+    p_tcb_t itr = NULL;
+    uint32_t usage;
+
+    printf("cpu usage:\r\n");
+    list_for_each_entry(itr, &g_task_list_head, task_list) {
+        usage = task_get_cpu_usage(itr);
+        printf("task name: %-20s | usage: %3lu.%lu%%\r\n", itr->name, usage / 10, usage % 10);
+    }
+    usage = os_get_cpu_load();
+    printf("cpu load: %3lu.%lu%%\r\n", usage / 10, usage % 10);
+}
+#endif
+
+#if OS_BUDGET
+/*
+ * This function is used to set execution time budget of the given task.
+ * Budget is consumed by running ticks of the task, and is replenished @period ticks after
+ * the task starts consuming it. When it is exhausted, the task is suspended or demoted.
+ * Input:
+ * task_handler: task control block of task
+ * budget:       budget in tick
+ * period:       replenishment period in tick
+ * policy:       action when budget is exhausted
+ * prio:         background priority for BUDGET_DEMOTE
+ * Output:
+ * result:       0 - ok
+ *               1 - fail
+ */
+err_t task_set_budget(p_tcb_t task_handler,
+                      uint32_t budget,
+                      uint32_t period,
+                      budget_policy_t policy,
+                      uint8_t prio)
+{
+    if (task_handler == NULL || budget == 0 || period < budget || prio >= OS_PRIO_MAX) {
+        return ERR_FAIL;
+    }
+
+    uint32_t level = interrupt_disable();
+    if (task_handler->budget != 0) {
+        //budget can only be set once
+        interrupt_enable(level);
+        return ERR_FAIL;
+    }
+
+    task_handler->budget = budget;
+    task_handler->budget_left = budget;
+    task_handler->budget_period = period;
+    task_handler->budget_exhaust = 0;
+    task_handler->budget_policy = policy;
+    task_handler->budget_prio = prio;
+    task_handler->budget_exhausted = 0;
+    task_handler->replenish_pending = 0;
+    interrupt_enable(level);
+
+    return ERR_OK;
+}
+
+/*
+ * This function is used to charge one tick to the budget of running task, called in tick interrupt.
+ * Input:
+ * task_handler: handler of running task
+ * Output:
+ * 1 if budget is exhausted and the task is suspended or demoted, otherwise 0
+ */
+static uint8_t budget_charge(p_tcb_t task_handler)
+{
+    if (task_handler->budget == 0 || task_handler->budget_exhausted) {
+        return 0;
+    }
+
+    if (!task_handler->replenish_pending) {
+        //sporadic server, consumed budget is replenished one period after consumption starts
+        task_handler->replenish_pending = 1;
+        task_handler->replenish_tick = g_os_tick - 1 + task_handler->budget_period;
+
+        p_tcb_t itr = NULL;
+        list_for_each_entry(itr, &g_budget_list_head, budget_list) {
+            if ((int32_t)(itr->replenish_tick - task_handler->replenish_tick) > 0) {
+                break;
+            }
+        }
+        list_add_before(&task_handler->budget_list, &itr->budget_list);
+    }
+
+    task_handler->budget_left--;
+    if (task_handler->budget_left != 0) {
+        return 0;
+    }
+
+    //budget is exhausted
+    task_handler->budget_exhausted = 1;
+    task_handler->budget_exhaust++;
+    if (task_handler->budget_policy == BUDGET_SUSPEND) {
+        remove_task_from_list(task_handler);
+        task_handler->state = TASK_PENDING;
+    } else {
+        task_handler->budget_origin_prio = task_handler->prio;
+        task_change_prio(task_handler, task_handler->budget_prio);
+    }
+    return 1;
+}
+
+/*
+ * This function is used to replenish budget of tasks whose replenish tick is reached, called in tick interrupt.
+ * Input:
+ * none
+ * Output:
+ * 1 if any suspended or demoted task is restored, otherwise 0
+ */
+static uint8_t budget_replenish(void)
+{
+    uint8_t restored = 0;
+
+    while (!list_empty(&g_budget_list_head)) {
+        p_tcb_t task = list_entry(g_budget_list_head.next, typeof(tcb_t), budget_list);
+        if ((int32_t)(g_os_tick - task->replenish_tick) < 0) {
+            break;
+        }
+
+        list_del(&task->budget_list);
+        task->replenish_pending = 0;
+        task->budget_left = task->budget;
+
+        if (task->budget_exhausted) {
+            task->budget_exhausted = 0;
+            if (task->budget_policy == BUDGET_SUSPEND) {
+                task->state = TASK_READY;
+                insert_task_to_list(task);
+            } else {
+                task_change_prio(task, task->budget_origin_prio);
+            }
+            restored = 1;
+        }
+    }
+    return restored;
+}
+#endif
+
+/*
+ * This function is used to update task state
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void update_task_state(void)
+{
+    g_os_tick++;
+    if (g_os_tick == 0) {
+        g_os_tick_high++;
+    }
+
+    //scheduler is not started yet, g_cur_task is set before psp is ready so it cannot tell
+    if (!g_os_started) {
+        return;
+    }
+
+    uint8_t resched = 0;
+
+#if OS_BUDGET
+    //running task is charged before time slice, it may be suspended or demoted here
+    if (g_cur_task->state == TASK_RUNNING) {
+        resched |= budget_charge(g_cur_task);
+    }
+    resched |= budget_replenish();
+#endif
+
+    //only the running task consumes its time slice, edf task runs until its job is done
+#if OS_EDF
+    if (g_cur_task->state == TASK_RUNNING && !TASK_IN_EDF_HEAP(g_cur_task)) {
+#else
+    if (g_cur_task->state == TASK_RUNNING) {
+#endif
+        g_cur_task->init_tick_left--;
+
+        if (g_cur_task->init_tick_left == 0) {
+            //time silce use up, reset time slice, remove to the end of list and ready to be scheduled
+            g_cur_task->init_tick_left = g_cur_task->init_tick;
+            g_cur_task->state = TASK_READY;
+            list_del(&g_cur_task->list);
+            list_add_before(&g_cur_task->list, &g_ready_list[g_cur_task->prio]);
+            resched = 1;
+        }
+    }
+
+#if OS_CPU_USAGE
+    if (g_os_tick - g_window_start_tick >= OS_CPU_USAGE_WINDOW) {
+        cpu_usage_update();
+    }
+#endif
+
+#if OS_CPU_USAGE
+    uint32_t now_cycles = DWT_CYCCNT;
+#endif
+
+    //delay list is sorted, stop at the first task which is not expired
+    while (!list_empty(&g_delay_list_head)) {
+        p_tcb_t task = list_entry(g_delay_list_head.next, typeof(tcb_t), delay_list);
+        if ((int32_t)(g_os_tick - task->wake_tick) < 0) {
+            break;
+        }
+
+        //set the task ready to be scheduled
+#if OS_CPU_USAGE
+        task->wake_cycles = now_cycles;
+#endif
+        list_del(&task->delay_list);
+        if (task->list.next != NULL) {
+            //ipc is timeout, the task is still in pending list
+            list_del(&task->list);
+            task->error = ERR_TIMEOUT;
+        }
+        task->state = TASK_READY;
+        insert_task_to_list(task);
+        resched = 1;
+    }
+
+    if (resched) {
+        //deferred to the end of tick interrupt
+        task_schedule();
+    }
+}
+
+__attribute__((naked)) void switch_msp_to_psp(void)
+{
+    //initialize psp
+    __asm volatile("PUSH {LR}");
+    __asm volatile("BL get_current_psp");
+    __asm volatile("MSR PSP, R0");
+    __asm volatile("POP {LR}");
+
+    //switch from msp to psp
+    __asm volatile("MOV R0, 0X02");
+    __asm volatile("MSR CONTROL, R0"); //write CONTROL register, SPSEL = 1, FPCA = 0
+    __asm volatile("ISB");
+    __asm volatile("BX LR");
+}
+
+/*
+ * This function is used to start os schedule
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void os_start_schedule(void)
+{
+    //PendSV and SysTick run at the lowest priority, HAL may have set SysTick to the highest one
+    SHPR3 |= (0xFFU << 16) | (0xFFU << 24);
+
+    //initialize
+    idle_task_create();
+#if OS_TIMER_TASK
+    soft_timer_task_create();
+#endif
+
+#if OS_USE_FPU
+    //enable automatic and lazy fpu state preservation, only tasks using fpu get extended frames
+    uint32_t *pFPCCR = (uint32_t *)0xE000EF34; //address of FPCCR
+    *pFPCCR |= (1 << 31) | (1 << 30); //set ASPEN and LSPEN
+#endif
+
+    //conversion factors of nanosecond time, system clock and SysTick are configured already
+    g_tick_cycles = SYST_LOAD + 1;
+    g_ns_per_tick = (uint64_t)1000000000U * g_tick_cycles / SystemCoreClock;
+    g_ns_per_cycle_q32 = ((uint64_t)1000000000U << 32) / SystemCoreClock;
+
+#if OS_TICKLESS_IDLE
+    tickless_init(g_tick_cycles);
+#endif
+
+#if OS_HRTIMER
+    hrtimer_init();
+#endif
+
+#if OS_CPU_USAGE
+    //enable DWT cycle counter, usage is counted from now on
+    DEMCR |= (1 << 24); //set TRCENA
+    DWT_CTRL |= 1; //set CYCCNTENA
+    g_switch_cycles = DWT_CYCCNT;
+    g_window_start_cycles = g_switch_cycles;
+    g_window_start_tick = g_os_tick;
+#endif
 
     switch_msp_to_psp();
 
     //schedule
     g_cur_task->state = TASK_RUNNING;
+    g_os_started = 1;
     ((void (*) (void *))g_cur_task->entry)(g_cur_task->parameter);
 }
 
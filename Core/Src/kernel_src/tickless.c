@@ -0,0 +1,147 @@
+/*
+ * Created by mikePPeng.
+ * This file implements tickless idle, SysTick is reprogrammed to sleep over several ticks at once.
+ * Change Logs:
+ * Date           Notes
+ * Oct 18, 2026   the first version
+ * Oct 18, 2026   take SysTick counts of one tick from scheduler
+ */
+
+#include "stm32f4xx_hal.h"
+#include "kernel_inc/soft_timer.h"
+#include "kernel_inc/task.h"
+#include "kernel_inc/tickless.h"
+
+static uint32_t g_tick_cycles = 0;      //SysTick counts of one tick, given by scheduler
+static uint32_t g_max_idle_ticks = 0;   //max ticks the 24-bit SysTick can sleep over
+static volatile uint32_t g_wakeups = 0;
+
+/*
+ * This function is used to initialize tickless idle, it must be called after SysTick is configured.
+ * Input:
+ * tick_cycles: SysTick counts of one tick
+ * Output:
+ * none
+ */
+void tickless_init(uint32_t tick_cycles)
+{
+    g_tick_cycles = tick_cycles;
+    g_max_idle_ticks = SysTick_LOAD_RELOAD_Msk / g_tick_cycles;
+}
+
+/*
+ * This function is used to sleep until the next interrupt, with periodic tick kept.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+static void idle_sleep(void)
+{
+    HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+    g_wakeups++;
+}
+
+/*
+ * This function is used to put cpu into sleep until next task or timer wakes up.
+ * It is called by idle task only.
+ * Input:
+ * none
+ * Output:
+ * none
+ */
+void tickless_idle(void)
+{
+    uint32_t expected;
+    uint32_t timer_ticks;
+
+    //PRIMASK is used here, pending interrupt still wakes up WFI but is not taken until tick is corrected
+    __disable_irq();
+
+    if (!task_is_idle_only()) {
+        __enable_irq();
+        return;
+    }
+
+    expected = task_get_next_wake();
+    timer_ticks = soft_timer_get_next_timeout();
+    if (timer_ticks < expected) {
+        expected = timer_ticks;
+    }
+
+    if (expected < OS_TICKLESS_MIN_TICK) {
+        //too close to the next tick, keep periodic tick
+        __enable_irq();
+        idle_sleep();
+        return;
+    }
+
+    if (expected > g_max_idle_ticks) {
+        expected = g_max_idle_ticks;
+    }
+
+    //stop SysTick, the rest of current tick plus (@expected - 1) whole ticks are slept over
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        //tick is already pending, do not sleep
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        __enable_irq();
+        return;
+    }
+
+    uint32_t reload = SysTick->VAL + g_tick_cycles * (expected - 1);
+    SysTick->LOAD = reload;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+    __ISB();
+    g_wakeups++;
+
+    //reading CTRL clears COUNTFLAG, so read it only once
+    uint32_t ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+
+    uint32_t complete;
+    if (ctrl & SysTick_CTRL_COUNTFLAG_Msk) {
+        //woken up by SysTick, the pending tick interrupt processes the last tick
+        uint32_t overrun = reload - SysTick->VAL;
+        complete = expected - 1;
+
+        if (overrun >= g_tick_cycles - 1) {
+            SysTick->LOAD = g_tick_cycles - 1;
+        } else {
+            SysTick->LOAD = g_tick_cycles - 1 - overrun;
+        }
+    } else {
+        //woken up by other interrupt, count the whole ticks slept and finish the current one
+        uint32_t elapsed = g_tick_cycles * expected - SysTick->VAL;
+        complete = elapsed / g_tick_cycles;
+        SysTick->LOAD = (complete + 1) * g_tick_cycles - elapsed;
+    }
+
+    //restart SysTick with the remaining part of current tick, then back to normal period
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = g_tick_cycles - 1;
+
+    //correct tick count, nothing expires during these ticks
+    os_tick_step(complete);
+    soft_timer_step(complete);
+
+    __enable_irq();
+}
+
+/*
+ * This function is used to get the number of wake-ups from idle sleep.
+ * Input:
+ * none
+ * Output:
+ * wake-up count since os is started
+ */
+uint32_t tickless_get_wakeups(void)
+{
+    return g_wakeups;
+}
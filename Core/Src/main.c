@@ -114,6 +114,63 @@ int main(void)
 
 //  extern void memory_sample_entry(void);
 //  memory_sample_entry();
+
+//  extern void tickless_sample_entry(void);
+//  tickless_sample_entry();
+
+//  extern void fpu_sample_entry(void);
+//  fpu_sample_entry();
+
+//  extern void cpu_usage_sample_entry(void);
+//  cpu_usage_sample_entry();
+
+//  extern void periodic_sample_entry(void);
+//  periodic_sample_entry();
+
+//  extern void edf_sample_entry(void);
+//  edf_sample_entry();
+
+//  extern void budget_sample_entry(void);
+//  budget_sample_entry();
+
+//  extern void timer_wheel_sample_entry(void);
+//  timer_wheel_sample_entry();
+
+//  extern void timer_burst_sample_entry(void);
+//  timer_burst_sample_entry();
+
+//  extern void hrtimer_sample_entry(void);
+//  hrtimer_sample_entry();
+
+//  extern void timer_slack_sample_entry(void);
+//  timer_slack_sample_entry();
+
+//  extern void time_sample_entry(void);
+//  time_sample_entry();
+
+//  extern void ipc_timeout_sample_entry(void);
+//  ipc_timeout_sample_entry();
+
+//  extern void irq_latency_sample_entry(void);
+//  irq_latency_sample_entry();
+
+//  extern void isr_sample_entry(void);
+//  isr_sample_entry();
+
+//  extern void mq_static_sample_entry(void);
+//  mq_static_sample_entry();
+
+//  extern void mq_backpressure_sample_entry(void);
+//  mq_backpressure_sample_entry();
+
+//  extern void mq_zero_copy_sample_entry(void);
+//  mq_zero_copy_sample_entry();
+
+//  extern void ringbuf_sample_entry(void);
+//  ringbuf_sample_entry();
+
+//  extern void notify_sample_entry(void);
+//  notify_sample_entry();
 }
 
 /**